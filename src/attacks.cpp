@@ -1,112 +1,71 @@
 #include "attacks.hpp"
 
-namespace attacks {  
+#ifdef USE_PEXT
+#include <immintrin.h>
+#endif
 
-static Bitboard calculatePawnAttacks(Square square, Color color);
-static Bitboard calculateKnightAttacks(Square square);
-static Bitboard calculateKingAttacks(Square square);
-static Bitboard calculateBishopAttacks(Square square, Bitboard blockers = 0ULL);
-static Bitboard calculateRookAttacks(Square square, Bitboard blockers = 0ULL);
-
-static Bitboard calculateBishopMask(Square square);
-static Bitboard calculateRookMask(Square square);
-
-static Bitboard getBlockerConfiguration(int index, Bitboard attack_mask);
-static Bitboard findMagicNumber(Square square, bool is_bishop);
-static Bitboard magicTransform(Bitboard masked_blockers, Bitboard magic, int bits);
+namespace attacks {
 
 static Bitboard lookupBishopAttacks(Square square, Bitboard blockers = 0ULL);
 static Bitboard lookupRookAttacks(Square square, Bitboard blockers = 0ULL);
 
-static void initializeMagicAttack(Square square, bool is_bishop);
-
-static uint64_t getRandomU64();
-static uint64_t getRandomU64Sparse();
-
-struct Magic {
-    Bitboard magic;
-    Bitboard mask;
-    int mask_bits;
+/* Per-square lookup information for the sliding pieces. The attacks of all
+ * squares are stored in one shared table, each square only occupying as many
+ * entries as it has blocker configurations. The struct is aligned such that it
+ * never straddles two cache lines. */
+struct alignas(32) Magic {
+    Bitboard mask;      // relevant blocker squares
+    Bitboard magic;     // magic number for hashing the blocker configuration
+    uint32_t offset;    // offset of the square's attacks in the shared table
+    uint32_t shift;     // number of bits to shift the hashed configuration by
 };
 
-static const int MAX_ATTACKS = 4096;
-
-static Magic bishop_magics[N_SQUARES];
-static Magic rook_magics[N_SQUARES];
-
-static Bitboard pawn_attacks[N_COLORS][N_SQUARES];
-static Bitboard knight_attacks[N_SQUARES];
-static Bitboard king_attacks[N_SQUARES];
-static Bitboard bishop_attacks[N_SQUARES][MAX_ATTACKS];
-static Bitboard rook_attacks[N_SQUARES][MAX_ATTACKS];
-
-static std::random_device rd;
-static std::mt19937_64 rng(rd());
-static std::uniform_int_distribution<uint64_t> dist(0, UINT64_MAX);
-
-void precalculate(bool info) {
-    if (info) {
-        std::cout << "Initializing attack tables, please wait..." << std::endl;
-    }
-    for (int square = 0; square < N_SQUARES; square++) {
-        // generate attack maps for all leaping pieces
-        for (int color = WHITE; color < N_COLORS; ++color){
-            pawn_attacks[color][square] = calculatePawnAttacks(square, color);
-        }
-        knight_attacks[square] = calculateKnightAttacks(square);
-        king_attacks[square] = calculateKingAttacks(square);
-
-        // generate attack masks for bishop and rook
-        bishop_magics[square].mask = calculateBishopMask(square);
-        bishop_magics[square].mask_bits = bb::count(bishop_magics[square].mask);
-        rook_magics[square].mask = calculateRookMask(square);
-        rook_magics[square].mask_bits = bb::count(rook_magics[square].mask);
-
-        // generate magic attack tables for the bishops and rooks
-        initializeMagicAttack(square, true);
-        initializeMagicAttack(square, false);
-
-        // print a progress bar if requested
-        if (info) {
-            std::cout << utils::getProgressBar(square + 1, N_SQUARES) << "\r";
-        }
-    }
-    if (info) {
-        std::cout << std::endl;
-    }
-    
-}
-
-template <PieceType TPieceType>
-Bitboard getPieceAttacks(Square square, Bitboard blockers) {
-    assert(TPieceType != PAWN);  // this function is not used for pawns
-    
-    switch (TPieceType) {
-        case KNIGHT:
-            return knight_attacks[square];
-            break;
-        case BISHOP:
-            return lookupBishopAttacks(square, blockers);
-            break;
-        case ROOK:
-            return lookupRookAttacks(square, blockers);
-            break;
-        case QUEEN:
-            return lookupBishopAttacks(square, blockers) | lookupRookAttacks(square, blockers);
-            break;
-        case KING:
-            return king_attacks[square];
-            break;
-        default:
-            throw std::invalid_argument("Invalid piece type.");
-    }
-}
+using LeaperAttackTable = std::array<Bitboard, N_SQUARES>;
+using MagicTable = std::array<Magic, N_SQUARES>;
+using SquarePairTable = std::array<std::array<Bitboard, N_SQUARES>, N_SQUARES>;
+
+/* Magic numbers for the sliding piece attack lookup. They have been found once
+ * by a brute-force random search and are verified during table generation, an
+ * invalid magic number therefore results in a compilation error. */
+static constexpr Bitboard BISHOP_MAGIC_NUMBERS[N_SQUARES] = {
+    0x000220441514c500ULL, 0x001021a801034008ULL, 0x18110c0086000805ULL, 0x0008208020200000ULL,
+    0x0401104000028000ULL, 0x0801016070200011ULL, 0x0006011108400001ULL, 0x0432024104108201ULL,
+    0x04000a2011140b10ULL, 0x1000102408108820ULL, 0x480031010c011000ULL, 0x02041c04009c4008ULL,
+    0x04401a02103088c0ULL, 0xe048008a30400000ULL, 0x8442404212104082ULL, 0x8102008c04220200ULL,
+    0x0010000431220800ULL, 0x0284011328080500ULL, 0x0008805108010100ULL, 0x0214002041002000ULL,
+    0x2084208202010208ULL, 0x8042001040622008ULL, 0x000480840409480aULL, 0x0133800101611000ULL,
+    0x0220880050a20801ULL, 0x0004200010020080ULL, 0x5000300088004040ULL, 0x0002008008008003ULL,
+    0x0020404004010040ULL, 0x0280448001101000ULL, 0x2001040000440408ULL, 0x0000410000940520ULL,
+    0x0202104012900200ULL, 0x0002100240840824ULL, 0x4003140206100088ULL, 0x1010c04800248200ULL,
+    0x00108a0084460080ULL, 0x00040400880c1008ULL, 0x31442c2042141100ULL, 0x0202320648816406ULL,
+    0x4004220804044000ULL, 0x0004442404802042ULL, 0x8486222130021800ULL, 0x3408084010450200ULL,
+    0x0480082008200100ULL, 0x6240008913000210ULL, 0x0009410804844201ULL, 0x1001420403042640ULL,
+    0x0004009404620000ULL, 0x5040888808820001ULL, 0x0081804200d00280ULL, 0x68a0000242022040ULL,
+    0x8450401020220008ULL, 0x0020080248020004ULL, 0x1888200454004000ULL, 0x010a448815830002ULL,
+    0x0004410068200400ULL, 0x0040208848280400ULL, 0x8210060020841001ULL, 0x6000054010c20a00ULL,
+    0x5188500004450408ULL, 0x8300400803380202ULL, 0x0000100441080203ULL, 0x0020040088010821ULL
+};
 
-Bitboard getPawnAttacks(Square square, Color color) {
-    return pawn_attacks[color][square];
-}
+static constexpr Bitboard ROOK_MAGIC_NUMBERS[N_SQUARES] = {
+    0x0080004000208010ULL, 0x0100108040002100ULL, 0x0200082010420080ULL, 0x2080080004100080ULL,
+    0x0280080002040081ULL, 0xa200082e00018410ULL, 0x010004030011e200ULL, 0x2200002040840102ULL,
+    0x0001800040102286ULL, 0x0002401000442001ULL, 0x1018801004802000ULL, 0x4380800800801004ULL,
+    0x0801001008010004ULL, 0x1092000200700804ULL, 0x0101000401000200ULL, 0x0420800041000080ULL,
+    0x0040008000308842ULL, 0x0020044010004020ULL, 0x8010420010820020ULL, 0x2118008010000880ULL,
+    0x0040808008000400ULL, 0x0138808002000400ULL, 0x0021010100040200ULL, 0x2055020001264184ULL,
+    0x0000400180008028ULL, 0x0010200840005002ULL, 0x0410008080102000ULL, 0x0800080280100080ULL,
+    0x0000080100050010ULL, 0x0709000300040008ULL, 0x0080010400480250ULL, 0x5114050a00004094ULL,
+    0x3100804000800020ULL, 0x8000400084802006ULL, 0x0008882000801000ULL, 0x0408100080800800ULL,
+    0x0880810401800800ULL, 0x2100020080800400ULL, 0x2805008419002200ULL, 0xc080042042000091ULL,
+    0x1140008040208000ULL, 0x0000500020004008ULL, 0x4020102001010041ULL, 0x00c0100100090021ULL,
+    0x8018080004008080ULL, 0x0020040002008080ULL, 0x000010080a0c0011ULL, 0x091020c100aa0014ULL,
+    0x01c0800030400080ULL, 0x10c0802008400680ULL, 0x0142200080100480ULL, 0x8000d20040a04a00ULL,
+    0x0481001288000500ULL, 0x0992001004080200ULL, 0x800a000401880200ULL, 0x0082010070840a00ULL,
+    0x0040210880001241ULL, 0x1082148100402202ULL, 0x2204410008200011ULL, 0x1c420a00200e4106ULL,
+    0x20220008c4601082ULL, 0x0212000104081082ULL, 0x0000011002008804ULL, 0x0124050028805402ULL
+};
 
-static Bitboard calculatePawnAttacks(Square square, Color color) {
+static constexpr Bitboard calculatePawnAttacks(Square square, Color color) {
     Bitboard bitboard = bb::getBitboard(square);
     Bitboard attacks = 0ULL;
 
@@ -123,7 +82,7 @@ static Bitboard calculatePawnAttacks(Square square, Color color) {
     return attacks;
 }
 
-static Bitboard calculateKnightAttacks(Square square) {
+static constexpr Bitboard calculateKnightAttacks(Square square) {
     Bitboard bitboard = bb::getBitboard(square);
     Bitboard attacks = 0ULL;
     attacks |= (
@@ -139,7 +98,7 @@ static Bitboard calculateKnightAttacks(Square square) {
     return attacks;
 }
 
-static Bitboard calculateKingAttacks(Square square) {
+static constexpr Bitboard calculateKingAttacks(Square square) {
     Bitboard bitboard = bb::getBitboard(square);
     Bitboard attacks = 0ULL;
     attacks |= (
@@ -155,7 +114,7 @@ static Bitboard calculateKingAttacks(Square square) {
     return attacks;
 }
 
-static Bitboard calculateBishopAttacks(Square square, Bitboard blockers) {
+static constexpr Bitboard calculateBishopAttacks(Square square, Bitboard blockers = 0ULL) {
     Bitboard bitboard = bb::getBitboard(square);
     Bitboard attacks = 0ULL;
     Bitboard bb;
@@ -182,11 +141,11 @@ static Bitboard calculateBishopAttacks(Square square, Bitboard blockers) {
     return attacks;
 }
 
-Bitboard calculateRookAttacks(Square square, Bitboard blockers) {
+static constexpr Bitboard calculateRookAttacks(Square square, Bitboard blockers = 0ULL) {
     Bitboard bitboard = bb::getBitboard(square);
     Bitboard attacks = 0ULL;
     Bitboard bb;
-    for (Bitboard bb = bitboard; (bb & ~RANK_8_BB) != 0; bb <<= 8) {  // north
+    for (bb = bitboard; (bb & ~RANK_8_BB) != 0; bb <<= 8) {  // north
         Bitboard attacked_square = bb << 8;
         attacks |= attacked_square;
         if (blockers & attacked_square) break;
@@ -209,13 +168,13 @@ Bitboard calculateRookAttacks(Square square, Bitboard blockers) {
     return attacks;
 }
 
-static Bitboard calculateBishopMask(Square square) {
+static constexpr Bitboard calculateBishopMask(Square square) {
     Bitboard attacks = calculateBishopAttacks(square, 0ULL);
     attacks &= ~EDGE_BB;
     return attacks;
 }
 
-static Bitboard calculateRookMask(Square square) {
+static constexpr Bitboard calculateRookMask(Square square) {
     Bitboard attacks = calculateRookAttacks(square, 0ULL);
     Bitboard bb = bb::getBitboard(square);
     
@@ -241,41 +200,7 @@ static Bitboard calculateRookMask(Square square) {
     return attacks;
 }
 
-static Bitboard lookupBishopAttacks(Square square, Bitboard blockers) {
-    // get attack mask and mask the given blockers
-    Bitboard masked_blockers = blockers & bishop_magics[square].mask;
-
-    // lookup magic number for the given square
-    Bitboard magic = bishop_magics[square].magic;
-
-    // lookup relevant bits
-    int bits = bishop_magics[square].mask_bits;
-
-    // transform the blockers to obtain the index for the final lookup
-    Bitboard blockers_index = attacks::magicTransform(masked_blockers, magic, bits);
-
-    // lookup the actual attack pattern from the pregenerated attack table
-    return attacks::bishop_attacks[square][blockers_index];
-}
-
-static Bitboard lookupRookAttacks(Square square, Bitboard blockers) {
-    // get attack mask and mask the given blockers
-    Bitboard masked_blockers = blockers & rook_magics[square].mask;
-
-    // lookup magic number for the given square
-    Bitboard magic = rook_magics[square].magic;
-
-    // lookup relevant bits
-    int bits = rook_magics[square].mask_bits;
-
-    // transform the blockers to obtain the index for the final lookup
-    Bitboard blockers_index = attacks::magicTransform(masked_blockers, magic, bits);
-
-    // lookup the actual attack pattern from the pregenerated attack table
-    return attacks::rook_attacks[square][blockers_index];
-}
-
-static Bitboard getBlockerConfiguration(int index, Bitboard attack_mask) {
+static constexpr Bitboard getBlockerConfiguration(int index, Bitboard attack_mask) {
     // get number of relevant bits for the given attack mask
     int bits = bb::count(attack_mask);
     // initialize empty configuration
@@ -292,94 +217,204 @@ static Bitboard getBlockerConfiguration(int index, Bitboard attack_mask) {
     return configuration;
 }
 
-static Bitboard magicTransform(Bitboard masked_blockers, Bitboard magic, int bits) {
+static constexpr Bitboard magicTransform(Bitboard masked_blockers, Bitboard magic, int bits) {
     return (masked_blockers * magic) >> (64 - bits);
 }
 
-static Bitboard findMagicNumber(Square square, bool is_bishop) {
-    // initialize arrays for blockers, attacks, and used indices
-    Bitboard blockers[MAX_ATTACKS], attacks[MAX_ATTACKS], used[MAX_ATTACKS];
+/* Obtain the attack table index of a blocker configuration. With BMI2 support,
+ * the relevant blocker bits are extracted directly using PEXT, otherwise they
+ * are hashed using the magic number. */
+static inline Bitboard getSliderIndex(Bitboard blockers, const Magic& magic) {
+#ifdef USE_PEXT
+    return magic.offset + _pext_u64(blockers, magic.mask);
+#else
+    return magic.offset + (((blockers & magic.mask) * magic.magic) >> magic.shift);
+#endif
+}
 
-    // get attack mask and number of relevant bits
-    Bitboard attack_mask = is_bishop ? bishop_magics[square].mask : rook_magics[square].mask;
-    int bits = is_bishop ? bishop_magics[square].mask_bits : rook_magics[square].mask_bits;
-    
-    // generate all possible blocker configurations and corresponding attacks
-    for (int i = 0; i < (1 << bits); i++) {
-        blockers[i] = getBlockerConfiguration(i, attack_mask);
-        attacks[i] = is_bishop ? calculateBishopAttacks(square, blockers[i]) : calculateRookAttacks(square, blockers[i]);
-    }        
-    // conduct brute-force random search for suitable magic numbers
-    for (int iteration = 0; iteration < 1e7; iteration++) {
-        // get magic number candidate
-        Bitboard magic_number = getRandomU64Sparse();
-        
-        // discard numbers that do not contain enough bits
-        if (bb::count((attack_mask * magic_number) & 0xFF00000000000000) < 6) continue;
-        
-        // reset array of used attacks
-        for (int i = 0; i < 4096; ++i) used[i] = 0ULL;
-        
-        // loop through all possible blocker configurations
-        int index;
-        bool collision;
-        for (index = 0, collision = false; !collision && index < (1 << bits); index++) {
-            // use the magic number to hash the masked attacks
-            int magic_index = attacks::magicTransform(blockers[index], magic_number, bits);
-
-            // the number is invalid if the hashed key is already in use
-            if (used[magic_index] == 0ULL) {
-                used[magic_index] = attacks[index];
-            // constructive collisions are fine, actual collisions are forbidden
-            } else if (used[magic_index] != attacks[index]) {
-                collision = true;
+static constexpr std::array<LeaperAttackTable, N_COLORS> initializePawnAttacks() {
+    std::array<LeaperAttackTable, N_COLORS> table{};
+    for (int color = WHITE; color < N_COLORS; ++color) {
+        for (int square = 0; square < N_SQUARES; square++) {
+            table[color][square] = calculatePawnAttacks(square, color);
+        }
+    }
+    return table;
+}
+
+static constexpr LeaperAttackTable initializeKnightAttacks() {
+    LeaperAttackTable table{};
+    for (int square = 0; square < N_SQUARES; square++) {
+        table[square] = calculateKnightAttacks(square);
+    }
+    return table;
+}
+
+static constexpr LeaperAttackTable initializeKingAttacks() {
+    LeaperAttackTable table{};
+    for (int square = 0; square < N_SQUARES; square++) {
+        table[square] = calculateKingAttacks(square);
+    }
+    return table;
+}
+
+static constexpr MagicTable initializeMagics(bool is_bishop, uint32_t offset) {
+    MagicTable magics{};
+    for (int square = 0; square < N_SQUARES; square++) {
+        magics[square].mask = is_bishop ? calculateBishopMask(square) : calculateRookMask(square);
+        magics[square].magic = is_bishop ? BISHOP_MAGIC_NUMBERS[square] : ROOK_MAGIC_NUMBERS[square];
+        magics[square].offset = offset;
+        magics[square].shift = 64 - bb::count(magics[square].mask);
+
+        // reserve one entry for each possible blocker configuration
+        offset += 1U << bb::count(magics[square].mask);
+    }
+    return magics;
+}
+
+static constexpr uint32_t getTableEnd(const MagicTable& magics) {
+    const Magic& last = magics[N_SQUARES - 1];
+    return last.offset + (1U << (64 - last.shift));
+}
+
+static constexpr MagicTable bishop_magics = initializeMagics(true, 0);
+static constexpr MagicTable rook_magics = initializeMagics(false, getTableEnd(bishop_magics));
+
+/* Total number of entries in the shared sliding piece attack table. */
+static constexpr uint32_t N_SLIDER_ATTACKS = getTableEnd(rook_magics);
+
+using SliderAttackTable = std::array<Bitboard, N_SLIDER_ATTACKS>;
+
+static constexpr void initializeMagicAttacks(SliderAttackTable& table, const MagicTable& magics, bool is_bishop) {
+    for (int square = 0; square < N_SQUARES; square++) {
+        const Magic& magic = magics[square];
+
+        // enumerate all subsets of the attack mask (Carry-Rippler trick), i.e.
+        // all possible blocker configurations, starting with the empty board
+        Bitboard blockers = 0ULL;
+        int subset_index = 0;
+        do {
+            Bitboard attack = is_bishop ? calculateBishopAttacks(square, blockers) : calculateRookAttacks(square, blockers);
+
+#ifdef USE_PEXT
+            // the subsets are enumerated in ascending order, which is exactly
+            // the order of the indices obtained by extracting the mask bits
+            int index = magic.offset + subset_index;
+#else
+            // store the attack map at the hashed magic index, constructive
+            // collisions are fine, actual collisions are forbidden
+            int index = magic.offset + magicTransform(blockers, magic.magic, 64 - magic.shift);
+            if (table[index] != 0ULL && table[index] != attack) {
+                throw MagicNotFoundException("Invalid magic number, colliding attack table entries.");
+            }
+#endif
+            table[index] = attack;
+
+            blockers = (blockers - magic.mask) & magic.mask;
+            subset_index++;
+        } while (blockers);
+    }
+}
+
+static constexpr SliderAttackTable initializeSliderAttacks() {
+    SliderAttackTable table{};
+    initializeMagicAttacks(table, bishop_magics, true);
+    initializeMagicAttacks(table, rook_magics, false);
+    return table;
+}
+
+static constexpr SquarePairTable initializeSquaresBetween() {
+    SquarePairTable table{};
+    for (int from = 0; from < N_SQUARES; from++) {
+        for (int to = 0; to < N_SQUARES; to++) {
+            Bitboard to_bb = bb::getBitboard(to);
+            Bitboard from_bb = bb::getBitboard(from);
+            // the squares in between are attacked from both ends of the ray
+            if (calculateBishopAttacks(from) & to_bb) {
+                table[from][to] = calculateBishopAttacks(from, to_bb) & calculateBishopAttacks(to, from_bb);
+            } else if (calculateRookAttacks(from) & to_bb) {
+                table[from][to] = calculateRookAttacks(from, to_bb) & calculateRookAttacks(to, from_bb);
             }
         }
-        // the magic number is valid if there are no collisions
-        if (!collision) return magic_number;
     }
-    
-    // throw an exception if no magic number has been found
-    throw MagicNotFoundException(
-        "No magic number found for square " + std::to_string(square) + "."
-    );
+    return table;
 }
 
-static void initializeMagicAttack(Square square, bool is_bishop) {
-    // obtain number of relevant bits
-    int bits = is_bishop ? bishop_magics[square].mask_bits : rook_magics[square].mask_bits;
-
-    // find magic number and store it in the table
-    Bitboard magic;
-    magic = attacks::findMagicNumber(square, is_bishop);
-
-    // get all possible blocker configurations and attacks
-    Bitboard blockers, attack;
-    Bitboard attack_mask = is_bishop ? bishop_magics[square].mask : rook_magics[square].mask;
-
-    for (int i = 0; i < (1 << bits); i++) {
-        // get blocker configuration and calculate attack
-        blockers = getBlockerConfiguration(i, attack_mask);
-        attack = is_bishop ? calculateBishopAttacks(square, blockers) : calculateRookAttacks(square, blockers);
-
-        // store the attack map at the hashed magic index
-        int magic_index = attacks::magicTransform(blockers, magic, bits);
-        if (is_bishop) {
-            bishop_magics[square].magic = magic;
-            bishop_attacks[square][magic_index] = attack;
-        } else {
-            rook_magics[square].magic = magic;
-            rook_attacks[square][magic_index] = attack;
+static constexpr SquarePairTable initializeLines() {
+    SquarePairTable table{};
+    for (int from = 0; from < N_SQUARES; from++) {
+        for (int to = 0; to < N_SQUARES; to++) {
+            Bitboard endpoints = bb::getBitboard(from) | bb::getBitboard(to);
+            // the line consists of the empty board attacks shared by both squares
+            if (calculateBishopAttacks(from) & bb::getBitboard(to)) {
+                table[from][to] = (calculateBishopAttacks(from) & calculateBishopAttacks(to)) | endpoints;
+            } else if (calculateRookAttacks(from) & bb::getBitboard(to)) {
+                table[from][to] = (calculateRookAttacks(from) & calculateRookAttacks(to)) | endpoints;
+            }
         }
     }
+    return table;
 }
 
-static uint64_t getRandomU64() {
-    return dist(rng);
+static constexpr std::array<LeaperAttackTable, N_COLORS> pawn_attacks = initializePawnAttacks();
+static constexpr LeaperAttackTable knight_attacks = initializeKnightAttacks();
+static constexpr LeaperAttackTable king_attacks = initializeKingAttacks();
+static constexpr SliderAttackTable slider_attacks = initializeSliderAttacks();
+
+static constexpr SquarePairTable squares_between = initializeSquaresBetween();
+static constexpr SquarePairTable lines = initializeLines();
+
+template <PieceType TPieceType>
+Bitboard getPieceAttacks(Square square, Bitboard blockers) {
+    assert(TPieceType != PAWN);  // this function is not used for pawns
+    
+    switch (TPieceType) {
+        case KNIGHT:
+            return knight_attacks[square];
+            break;
+        case BISHOP:
+            return lookupBishopAttacks(square, blockers);
+            break;
+        case ROOK:
+            return lookupRookAttacks(square, blockers);
+            break;
+        case QUEEN:
+            return lookupBishopAttacks(square, blockers) | lookupRookAttacks(square, blockers);
+            break;
+        case KING:
+            return king_attacks[square];
+            break;
+        default:
+            throw std::invalid_argument("Invalid piece type.");
+    }
 }
 
-static uint64_t getRandomU64Sparse() {
-    return getRandomU64() & getRandomU64() & getRandomU64();
+Bitboard getPawnAttacks(Square square, Color color) {
+    return pawn_attacks[color][square];
+}
+
+Bitboard getSquaresBetween(Square from, Square to) {
+    return squares_between[from][to];
+}
+
+Bitboard getLine(Square from, Square to) {
+    return lines[from][to];
+}
+
+static Bitboard lookupBishopAttacks(Square square, Bitboard blockers) {
+    // transform the blockers to obtain the index for the final lookup
+    Bitboard blockers_index = getSliderIndex(blockers, bishop_magics[square]);
+
+    // lookup the actual attack pattern from the pregenerated attack table
+    return attacks::slider_attacks[blockers_index];
+}
+
+static Bitboard lookupRookAttacks(Square square, Bitboard blockers) {
+    // transform the blockers to obtain the index for the final lookup
+    Bitboard blockers_index = getSliderIndex(blockers, rook_magics[square]);
+
+    // lookup the actual attack pattern from the pregenerated attack table
+    return attacks::slider_attacks[blockers_index];
 }
 
 template Bitboard getPieceAttacks<KNIGHT>(Square square, Bitboard blockers);
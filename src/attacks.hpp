@@ -3,16 +3,15 @@
 
 #include <array>
 #include <cassert>
-#include <random>
 #include "bitboard.hpp"
 #include "exceptions.hpp"
 #include "utils.hpp"
 
 namespace attacks {
 
-/* @brief Precalculate attack tables for all pieces. Must be called once before
- *  being able to use the attack module. */
-void precalculate(bool info = false);
+/* Note: All attack tables are generated at compile time from embedded magic
+ * numbers and live in read-only memory, no initialization is required before
+ * using the attack module. */
 
 /* @brief Get the attack bitboard representation for a given piece on a given
  *  square. The blocker configuration is only relevant for sliding pieces. For
@@ -30,6 +29,21 @@ Bitboard getPieceAttacks(Square square, Bitboard blockers);
  * @returns A bitboard representation of all attacked squares. */
 Bitboard getPawnAttacks(Square square, Color color);
 
+/* @brief Get the squares strictly between two squares that share a rank, file
+ *  or diagonal.
+ * @param from The first square.
+ * @param to The second square.
+ * @returns A bitboard of all squares in between, empty if the squares are not
+ *  aligned. */
+Bitboard getSquaresBetween(Square from, Square to);
+
+/* @brief Get the full line (rank, file or diagonal) through two squares.
+ * @param from The first square.
+ * @param to The second square.
+ * @returns A bitboard of the entire line from edge to edge including both
+ *  squares, empty if the squares are not aligned. */
+Bitboard getLine(Square from, Square to);
+
 }   // namespace attacks
 
 #endif
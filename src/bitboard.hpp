@@ -9,25 +9,25 @@
 
 namespace bb {
 
-inline Bitboard getBitboard(Square square) {
+inline constexpr Bitboard getBitboard(Square square) {
     return (1ULL << square);
 }
 
 Bitboard getBitboard(const std::vector<Square>& squares);
 
-inline void set(Bitboard& b, Square square) {
+inline constexpr void set(Bitboard& b, Square square) {
     b |= getBitboard(square);
 }
 
-inline bool get(Bitboard& b, Square square) {
+inline constexpr bool get(Bitboard b, Square square) {
     return ((b >> square) & 1ULL);
 }
 
-inline void clear(Bitboard& b, Square square) {
+inline constexpr void clear(Bitboard& b, Square square) {
     b &= ~getBitboard(square);
 }
 
-inline int count(Bitboard b) {
+inline constexpr int count(Bitboard b) {
 #ifdef __GNUC__
     return __builtin_popcountll(b);
 #else
@@ -38,7 +38,7 @@ inline int count(Bitboard b) {
 #endif
 }
 
-inline Square getLSB(Bitboard b) {
+inline constexpr Square getLSB(Bitboard b) {
     #ifdef __GNUC__
     assert(b);
     return Square(__builtin_ctzll(b));
@@ -48,7 +48,7 @@ inline Square getLSB(Bitboard b) {
 #endif
 }
 
-inline Square popLSB(Bitboard& b) {
+inline constexpr Square popLSB(Bitboard& b) {
     const Square square = getLSB(b);
     b &= b - 1;
     return square;
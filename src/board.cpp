@@ -1,19 +1,19 @@
 #include "board.hpp"
 
-Board::Board(const std::string& fen){
+Board::Board(const std::string& fen) : ply_(0) {
     // initialize empty bitboards
-    for (bool color : {WHITE, BLACK}){
-        for (PieceType pieceType = 0; pieceType < N_PIECE_TYPES; pieceType++) {
-            occupancies_.pieces[color][pieceType] = 0ULL;
-        }
-        occupancies_.colors[color] = 0ULL;
+    for (PieceType pieceType = 0; pieceType < N_PIECE_TYPES; pieceType++) {
+        occupancies().pieces[pieceType] = 0ULL;
+    }
+    for (Color color : {WHITE, BLACK}) {
+        occupancies().colors[color] = 0ULL;
     }
-    occupancies_.all = 0ULL;
 
     // initialize the array of pieces
     for (Square square = 0; square < N_SQUARES; square++) {
-        pieces_[square] = NO_PIECE;
+        pieces()[square] = NO_PIECE;
     }
+    accumulator() = EvalAccumulator{psqt::Score{0, 0}};
     
     // split the given FEN into groups that describe the board status
     std::vector<std::string> fen_groups = utils::tokenize(fen, ' ');
@@ -43,31 +43,25 @@ Board::Board(const std::string& fen){
             // set offset for piece referencing
             Color color = is_white ? WHITE : BLACK;
 
-            // update the occupancy bitboard in accordance to the pieces
+            // place the corresponding piece and update the occupancy bitboards
             switch (figure){
                 case 'p':
-                    bb::set(occupancies_.pieces[color][PAWN], square);
-                    pieces_[square] = is_white ? WHITE_PAWN : BLACK_PAWN;
+                    setPiece(square, make_piece(color, PAWN));
                     break;
                 case 'n':
-                    bb::set(occupancies_.pieces[color][KNIGHT], square);
-                    pieces_[square] = is_white ? WHITE_KNIGHT : BLACK_KNIGHT;
+                    setPiece(square, make_piece(color, KNIGHT));
                     break;
                 case 'b':
-                    bb::set(occupancies_.pieces[color][BISHOP], square);
-                    pieces_[square] = is_white ? WHITE_BISHOP : BLACK_BISHOP;
+                    setPiece(square, make_piece(color, BISHOP));
                     break;
                 case 'r':
-                    bb::set(occupancies_.pieces[color][ROOK], square);
-                    pieces_[square] = is_white ? WHITE_ROOK : BLACK_ROOK;
+                    setPiece(square, make_piece(color, ROOK));
                     break;
                 case 'q':
-                    bb::set(occupancies_.pieces[color][QUEEN], square);
-                    pieces_[square] = is_white ? WHITE_QUEEN : BLACK_QUEEN;
+                    setPiece(square, make_piece(color, QUEEN));
                     break;
                 case 'k':
-                    bb::set(occupancies_.pieces[color][KING], square);
-                    pieces_[square] = is_white ? WHITE_KING : BLACK_KING;
+                    setPiece(square, make_piece(color, KING));
                     break;
             }
             // proceed to next file
@@ -86,17 +80,8 @@ Board::Board(const std::string& fen){
         throw InvalidFENException(std::string("The specified FEN is invalid."));
     }
 
-    // update the occupancy bitboards
-    for (bool color : {WHITE, BLACK}) {
-        for (PieceType pieceType = 0; pieceType < N_PIECE_TYPES; pieceType++) {
-            Bitboard bb = occupancies_.pieces[color][pieceType];
-            occupancies_.colors[color] |= bb;
-        }
-        occupancies_.all |= occupancies_.colors[color];
-    }
-
-    // instantiate game state object
-    GameState gameState = GameState();
+    // set up the initial game state object
+    GameState& gameState = state();
 
     // handle side to move
     std::string fen_side_to_move = fen_groups[1];
@@ -136,68 +121,152 @@ Board::Board(const std::string& fen){
         }
     }
 
-    // TODO: handle move counters
+    // handle the halfmove clock, the fullmove number is not needed
+    gameState.halfmove_clock = (fen_groups.size() > 4) ? std::stoi(fen_groups[4]) : 0;
+
+    // hash the position, which requires the game state to be set up
+    gameState.captured = NO_PIECE;
+    gameState.key = computeKey();
+    gameState.pawn_key = computePawnKey();
+    gameState.material_key = computeMaterialKey();
 
-    // push the initial game state onto the game state history stack
-    game_state_history_.reserve(GAME_STATE_HISTORY_LENGTH);
-    game_state_history_.push_back(gameState);
+#ifdef USE_ATTACK_MAPS
+    // compute the attacks of all pieces
+    for (Square square = 0; square < N_SQUARES; square++) {
+        attack_maps_.attacks_from[square] = 0ULL;
+        attack_maps_.attackers_to[square] = 0ULL;
+    }
+    updateAttackMaps(getTotalOccupancy());
+#endif
+
+    if (nnue::isLoaded()) {
+        refreshNetworkAccumulator();
+    }
+
+    updateCheckInfo();
 };
 
 Bitboard Board::getPieceOccupancy(PieceType pieceType, Color color) const {
-    return occupancies_.pieces[color][pieceType];
+    return occupancies().pieces[pieceType] & occupancies().colors[color];
 }
 
 Bitboard Board::getColorOccupancy(Color color) const {
-    return occupancies_.colors[color];
+    return occupancies().colors[color];
 }
 
 Bitboard Board::getTotalOccupancy() const {
-    return occupancies_.all;
+    return occupancies().pieces[NO_PIECE_TYPE];
 }
 
 Piece Board::getPieceOnSquare(Square square) const {
-    return pieces_[square];
+    return pieces()[square];
 }
 
 Square Board::getKingSquare(Color color) const {
-    return bb::getLSB(occupancies_.pieces[color][KING]);
+    return bb::getLSB(getPieceOccupancy(KING, color));
 }
 
 Bitboard Board::getCurrentEnPassantTarget() const {
-    return game_state_history_.back().en_passant_target;
+    return state().en_passant_target;
 }
 
 CastlingRight Board::getCastlingRights() const {
-    return game_state_history_.back().castling_rights;
+    return state().castling_rights;
 }
 
 bool Board::canCastle(CastlingRight cr) const {
-    return (game_state_history_.back().castling_rights & cr);
+    return (state().castling_rights & cr);
 }
 
 bool Board::isCastlingBlocked(CastlingRight cr) const {
-    return occupancies_.all & CASTLING_SQUARES[cr];
+    return getTotalOccupancy() & CASTLING_SQUARES[cr];
 }
 
 Color Board::getSideToMove() const {
-    return game_state_history_.back().side_to_move;
+    return state().side_to_move;
+}
+
+Key Board::getKey() const {
+    return state().key;
+}
+
+Key Board::getPawnKey() const {
+    return state().pawn_key;
+}
+
+Key Board::getMaterialKey() const {
+    return state().material_key;
+}
+
+Key Board::computeKey() const {
+    Key key = 0ULL;
+    Bitboard occupancy = getTotalOccupancy();
+    while (occupancy) {
+        Square square = bb::popLSB(occupancy);
+        key ^= zobrist::getPieceKey(pieces()[square], square);
+    }
+    key ^= zobrist::getCastlingKey(getCastlingRights());
+    Bitboard en_passant_target = getCurrentEnPassantTarget();
+    if (en_passant_target) {
+        key ^= zobrist::getEnPassantKey(bb::getLSB(en_passant_target) % N_FILES);
+    }
+    if (getSideToMove() == BLACK) {
+        key ^= zobrist::getSideKey();
+    }
+    return key;
+}
+
+Key Board::computePawnKey() const {
+    Key key = 0ULL;
+    Bitboard pawns = occupancies().pieces[PAWN];
+    while (pawns) {
+        Square square = bb::popLSB(pawns);
+        key ^= zobrist::getPieceKey(pieces()[square], square);
+    }
+    return key;
+}
+
+Key Board::computeMaterialKey() const {
+    Key key = 0ULL;
+    for (Color color : {WHITE, BLACK}) {
+        for (PieceType pieceType = PAWN; pieceType <= KING; pieceType++) {
+            int count = bb::count(getPieceOccupancy(pieceType, color));
+            for (int i = 0; i < count; i++) {
+                key ^= zobrist::getMaterialKey(make_piece(color, pieceType), i);
+            }
+        }
+    }
+    return key;
+}
+
+EvalAccumulator Board::computeAccumulator() const {
+    EvalAccumulator computed = EvalAccumulator{psqt::Score{0, 0}};
+    for (Square square = 0; square < N_SQUARES; square++) {
+        Piece piece = pieces()[square];
+        if (piece != NO_PIECE) {
+            computed.score += psqt::getScore(piece, square);
+        }
+    }
+    return computed;
 }
 
 void Board::setPiece(Square square, Piece piece) {
-    //assert(pieces_[square] == NO_PIECE);  // assert that square is empty
-    bb::set(occupancies_.pieces[color_of(piece)][type_of(piece)], square);
-    bb::set(occupancies_.colors[color_of(piece)], square);
-    bb::set(occupancies_.all, square);
-    pieces_[square] = piece;
+    //assert(pieces()[square] == NO_PIECE);  // assert that square is empty
+    bb::set(occupancies().pieces[type_of(piece)], square);
+    bb::set(occupancies().colors[color_of(piece)], square);
+    bb::set(occupancies().pieces[NO_PIECE_TYPE], square);
+    pieces()[square] = piece;
+    accumulator().score += psqt::getScore(piece, square);
 }
 
 void Board::unsetPiece(Square square) {
-    Piece piece = pieces_[square];
+    Piece piece = pieces()[square];
     //assert((piece != NO_PIECE));  // assert that square is not empty
-    bb::clear(occupancies_.pieces[color_of(piece)][type_of(piece)], square);
-    bb::clear(occupancies_.colors[color_of(piece)], square);
-    bb::clear(occupancies_.all, square);
-    pieces_[square] = NO_PIECE;
+    bb::clear(occupancies().pieces[type_of(piece)], square);
+    bb::clear(occupancies().colors[color_of(piece)], square);
+    bb::clear(occupancies().pieces[NO_PIECE_TYPE], square);
+    pieces()[square] = NO_PIECE;
+    accumulator().score -= psqt::getScore(piece, square);
 }
 
 void Board::replacePiece(Square square, Piece piece) {
@@ -205,208 +274,819 @@ void Board::replacePiece(Square square, Piece piece) {
     setPiece(square, piece);
 }
 
-// NOTE: there are more efficient approaches than this
+/* @brief Get the attacks of a given piece.
+ * @param piece The piece, may be NO_PIECE.
+ * @param square The square of the piece.
+ * @param occupancy The occupancy to use for the sliding piece attacks.
+ * @return A bitboard of all attacked squares. */
+static Bitboard getAttacksOfPiece(Piece piece, Square square, Bitboard occupancy) {
+    switch (type_of(piece)) {
+        case PAWN:      return attacks::getPawnAttacks(square, color_of(piece));
+        case KNIGHT:    return attacks::getPieceAttacks<KNIGHT>(square, occupancy);
+        case BISHOP:    return attacks::getPieceAttacks<BISHOP>(square, occupancy);
+        case ROOK:      return attacks::getPieceAttacks<ROOK>(square, occupancy);
+        case QUEEN:     return attacks::getPieceAttacks<QUEEN>(square, occupancy);
+        case KING:      return attacks::getPieceAttacks<KING>(square, occupancy);
+        default:        return 0ULL;
+    }
+}
+
+#ifdef USE_ATTACK_MAPS
+void Board::updateAttackMaps(Bitboard changed) {
+    const OccupancyBitboards& occupancies = this->occupancies();
+    Bitboard sliders = occupancies.pieces[BISHOP] | occupancies.pieces[ROOK] | occupancies.pieces[QUEEN];
+
+    // the attacks of a slider can only change if it attacked a changed square
+    // before, which includes the pieces that have moved to or from the square
+    Bitboard affected = changed;
+    while (changed) {
+        affected |= attack_maps_.attackers_to[bb::popLSB(changed)] & sliders;
+    }
+
+    // withdraw the previous attacks of all affected squares and add new ones
+    Bitboard squares = affected;
+    while (squares) {
+        Square square = bb::popLSB(squares);
+        Bitboard attacked = attack_maps_.attacks_from[square];
+        while (attacked) {
+            bb::clear(attack_maps_.attackers_to[bb::popLSB(attacked)], square);
+        }
+    }
+    squares = affected;
+    while (squares) {
+        Square square = bb::popLSB(squares);
+        Bitboard attacked = getAttacksOfPiece(pieces()[square], square, occupancies.pieces[NO_PIECE_TYPE]);
+        attack_maps_.attacks_from[square] = attacked;
+        while (attacked) {
+            bb::set(attack_maps_.attackers_to[bb::popLSB(attacked)], square);
+        }
+    }
+
+    // collect the attacks of each side
+    for (Color color : {WHITE, BLACK}) {
+        Bitboard attacked = 0ULL;
+        Bitboard pieces = occupancies.colors[color];
+        while (pieces) {
+            attacked |= attack_maps_.attacks_from[bb::popLSB(pieces)];
+        }
+        attack_maps_.by_color[color] = attacked;
+    }
+}
+#endif
+
 bool Board::isAttackedBy(Square square, Color color) const {
+#ifdef USE_ATTACK_MAPS
+    return bb::get(attack_maps_.by_color[color], square);
+#else
     Color us = !color;
     Color them = color;
 
     // following the I-see-you-you-see-me approach, calculate piece attacks from
     // the initial square and check if the corresponding pieces can be attacked
-    Bitboard theirPawns = occupancies_.pieces[them][PAWN];
+    Bitboard theirPawns = getPieceOccupancy(PAWN, them);
     if (attacks::getPawnAttacks(square, us) & theirPawns) {
         return true;
     }
-    Bitboard theirKnights = occupancies_.pieces[them][KNIGHT];
+    Bitboard theirKnights = getPieceOccupancy(KNIGHT, them);
     if (attacks::getPieceAttacks<KNIGHT>(square, 0ULL) & theirKnights) {
         return true;
     }
-    Bitboard theirKing = occupancies_.pieces[them][KING];
+    Bitboard theirKing = getPieceOccupancy(KING, them);
     if (attacks::getPieceAttacks<KING>(square, 0ULL) & theirKing) {
         return true;
     }
-    Bitboard theirBishopsAndQueens = occupancies_.pieces[them][BISHOP] | occupancies_.pieces[them][QUEEN];
-    if (attacks::getPieceAttacks<BISHOP>(square, occupancies_.all) & theirBishopsAndQueens) {
+    Bitboard theirBishopsAndQueens = getPieceOccupancy(BISHOP, them) | getPieceOccupancy(QUEEN, them);
+    if (attacks::getPieceAttacks<BISHOP>(square, getTotalOccupancy()) & theirBishopsAndQueens) {
         return true;
     }
-    Bitboard theirRooksAndQueens = occupancies_.pieces[them][ROOK] | occupancies_.pieces[them][QUEEN];
-    if (attacks::getPieceAttacks<ROOK>(square, occupancies_.all) & theirRooksAndQueens) {
+    Bitboard theirRooksAndQueens = getPieceOccupancy(ROOK, them) | getPieceOccupancy(QUEEN, them);
+    if (attacks::getPieceAttacks<ROOK>(square, getTotalOccupancy()) & theirRooksAndQueens) {
         return true;
     }
     
     return false;
+#endif
 }
 
-bool Board::isInCheck(Color color) {
-    Square kingSquare = getKingSquare(color);
-    return isAttackedBy(kingSquare, !color);
+Bitboard Board::getAttackersTo(Square square, Bitboard occupancy) const {
+    const OccupancyBitboards& occupancies = this->occupancies();
+    Bitboard bishops_and_queens = occupancies.pieces[BISHOP] | occupancies.pieces[QUEEN];
+    Bitboard rooks_and_queens = occupancies.pieces[ROOK] | occupancies.pieces[QUEEN];
+    Bitboard knights = occupancies.pieces[KNIGHT];
+    Bitboard kings = occupancies.pieces[KING];
+
+    // a pawn attacks the square if a pawn of the opposite color on the square
+    // would attack the pawn
+    return (attacks::getPawnAttacks(square, BLACK) & getPieceOccupancy(PAWN, WHITE))
+         | (attacks::getPawnAttacks(square, WHITE) & getPieceOccupancy(PAWN, BLACK))
+         | (attacks::getPieceAttacks<KNIGHT>(square, 0ULL) & knights)
+         | (attacks::getPieceAttacks<BISHOP>(square, occupancy) & bishops_and_queens)
+         | (attacks::getPieceAttacks<ROOK>(square, occupancy) & rooks_and_queens)
+         | (attacks::getPieceAttacks<KING>(square, 0ULL) & kings);
 }
 
-void Board::makeMove(Move move) {                                               // TODO: add a movePiece function
+Bitboard Board::getAttackersTo(Square square) const {
+#ifdef USE_ATTACK_MAPS
+    return attack_maps_.attackers_to[square];
+#else
+    return getAttackersTo(square, getTotalOccupancy());
+#endif
+}
+
+Bitboard Board::getAttackedSquares(Color color) const {
+#ifdef USE_ATTACK_MAPS
+    return attack_maps_.by_color[color];
+#else
+    Bitboard attacked = 0ULL;
+    Bitboard pieces = getColorOccupancy(color);
+    while (pieces) {
+        Square square = bb::popLSB(pieces);
+        attacked |= getAttacksOfPiece(this->pieces()[square], square, getTotalOccupancy());
+    }
+    return attacked;
+#endif
+}
 
+void Board::updateCheckInfo() {
+    GameState& gameState = state();
     Color us = getSideToMove();
-    //Color them = !us;
+    Color them = !us;
+
+    for (Color color : {WHITE, BLACK}) {
+        Square king_square = getKingSquare(color);
+        gameState.blockers[color] = 0ULL;
+        gameState.pinners[!color] = 0ULL;
+
+        // find all enemy sliders that would attack the king on an empty board
+        Bitboard snipers = (attacks::getPieceAttacks<BISHOP>(king_square, 0ULL)
+                            & (getPieceOccupancy(BISHOP, !color) | getPieceOccupancy(QUEEN, !color)))
+                         | (attacks::getPieceAttacks<ROOK>(king_square, 0ULL)
+                            & (getPieceOccupancy(ROOK, !color) | getPieceOccupancy(QUEEN, !color)));
+
+        // a piece is a blocker if it is the only piece between king and sniper,
+        // the sniper pins it if it belongs to the king's side
+        while (snipers) {
+            Square sniper = bb::popLSB(snipers);
+            Bitboard between = attacks::getSquaresBetween(king_square, sniper) & getTotalOccupancy();
+            if (bb::count(between) == 1) {
+                gameState.blockers[color] |= between;
+                if (between & getColorOccupancy(color)) {
+                    bb::set(gameState.pinners[!color], sniper);
+                }
+            }
+        }
+    }
+
+    gameState.checkers = getAttackersTo(getKingSquare(us)) & getColorOccupancy(them);
+
+    // squares from which each of our pieces would attack the enemy king
+    Square their_king = getKingSquare(them);
+    Bitboard occupancy = getTotalOccupancy();
+    gameState.check_squares[PAWN] = attacks::getPawnAttacks(their_king, them);
+    gameState.check_squares[KNIGHT] = attacks::getPieceAttacks<KNIGHT>(their_king, occupancy);
+    gameState.check_squares[BISHOP] = attacks::getPieceAttacks<BISHOP>(their_king, occupancy);
+    gameState.check_squares[ROOK] = attacks::getPieceAttacks<ROOK>(their_king, occupancy);
+    gameState.check_squares[QUEEN] = gameState.check_squares[BISHOP] | gameState.check_squares[ROOK];
+    gameState.check_squares[KING] = 0ULL;
+}
+
+Bitboard Board::getKingBlockers(Color color) const {
+    return state().blockers[color];
+}
+
+Bitboard Board::getPinners(Color color) const {
+    return state().pinners[color];
+}
+
+Bitboard Board::getCheckers() const {
+    return state().checkers;
+}
+
+Bitboard Board::getCheckSquares(PieceType pieceType) const {
+    return state().check_squares[pieceType];
+}
+
+bool Board::givesCheck(Move move) const {
+    Color us = getSideToMove();
+    Color them = !us;
     Square from = move.getFrom();
     Square to = move.getTo();
-    Piece piece = pieces_[from];
-    Piece captured = move.isEnPassantCapture() ? ((us == WHITE) ? BLACK_PAWN : WHITE_PAWN) : pieces_[to];
+    Square their_king = getKingSquare(them);
+    const GameState& gameState = state();
 
-    GameState prev_game_state = game_state_history_.back();
-    GameState next_game_state = GameState();
-    next_game_state.castling_rights = prev_game_state.castling_rights;                  // TODO: implement copy constructor for game state that copies the relevant attributes
-    next_game_state.captured = captured;
-    next_game_state.side_to_move = !prev_game_state.side_to_move;
+    // direct check by the moving piece, promotions are handled below
+    if (!move.isPromotion() && bb::get(gameState.check_squares[type_of(pieces()[from])], to)) {
+        return true;
+    }
+
+    // discovered check by a piece leaving the line towards the enemy king
+    if (bb::get(gameState.blockers[them] & getColorOccupancy(us), from)
+        && !bb::get(attacks::getLine(their_king, from), to)) {
+        return true;
+    }
+
+    Bitboard occupancy = getTotalOccupancy() ^ bb::getBitboard(from);
+    switch (move.getFlag()) {
+        case EN_PASSANT_CAPTURE: {
+            // the captured pawn may uncover an attack of one of our sliders
+            Square captured_square = to + ((us == WHITE) ? SOUTH : NORTH);
+            occupancy = (occupancy ^ bb::getBitboard(captured_square)) | bb::getBitboard(to);
+            Bitboard queens = getPieceOccupancy(QUEEN, us);
+            return (attacks::getPieceAttacks<BISHOP>(their_king, occupancy) & (getPieceOccupancy(BISHOP, us) | queens))
+                 | (attacks::getPieceAttacks<ROOK>(their_king, occupancy) & (getPieceOccupancy(ROOK, us) | queens));
+        }
+        case KINGSIDE_CASTLE:
+        case QUEENSIDE_CASTLE: {
+            // only the rook can give check
+            bool kingside = move.getFlag() == KINGSIDE_CASTLE;
+            Square rook_from = kingside ? to + EAST : to + 2 * WEST;
+            Square rook_to = kingside ? to + WEST : to + EAST;
+            occupancy = (occupancy ^ bb::getBitboard(rook_from)) | bb::getBitboard(to) | bb::getBitboard(rook_to);
+            return bb::get(attacks::getPieceAttacks<ROOK>(rook_to, occupancy), their_king);
+        }
+        default:
+            if (move.isPromotion()) {
+                return bb::get(getAttacksOfPiece(make_piece(us, move.getPromotionPieceType()), to, occupancy), their_king);
+            }
+            return false;
+    }
+}
 
+bool Board::see(Move move, Value threshold) const {
+    // castling never loses or gains material
     if (move.isCastling()) {
-        // make sure the moving piece is the king
-        //assert(type_of(piece) == KING);    // moving piece must be the king
+        return 0 >= threshold;
+    }
 
-        // determine rook target square
-        Square rookFrom = get_square(us * RANK_8, (from < to) ? FILE_H : FILE_A);
-        Square rookTo = (from < to) ? to + WEST : to + EAST;
+    Square from = move.getFrom();
+    Square to = move.getTo();
+    Color side = !getSideToMove();
+    const GameState& gameState = state();
 
-        // move the king and the rook
-        unsetPiece(from);
-        setPiece(to, piece);
-        unsetPiece(rookFrom);
-        setPiece(rookTo, make_piece(us, ROOK));
+    // swap list, containing the material balance of the side that captures
+    // at each depth, assuming that the other side does not capture again
+    Value gain[32];
+    int depth = 0;
+    PieceType attacker = type_of(pieces()[from]);
+    Bitboard occupancy = getTotalOccupancy() ^ bb::getBitboard(from);
+    if (move.isEnPassantCapture()) {
+        gain[0] = PIECE_VALUES[PAWN];
+        occupancy ^= bb::getBitboard(to + ((side == BLACK) ? SOUTH : NORTH));
     } else {
-        // remove the moving piece from its old location
-        unsetPiece(from);
+        gain[0] = PIECE_VALUES[type_of(pieces()[to])];
+    }
+    if (move.isPromotion()) {
+        attacker = move.getPromotionPieceType();
+        gain[0] += PIECE_VALUES[attacker] - PIECE_VALUES[PAWN];
+    }
 
-        // handle promotions
-        if (move.isPromotion()) {
-            // handle captures
-            if (move.isCapture()) {
-                replacePiece(to, make_piece(us, move.getPromotionPieceType()));
-            } else {
-                setPiece(to, make_piece(us, move.getPromotionPieceType()));
-            }
-        } else {
-            // handle en passant captures
-            if (move.isEnPassantCapture()) {
-                // remove the pawn that has passed us
-                Bitboard enPassantTargetBB = getCurrentEnPassantTarget();
-                Square enPassantTarget = bb::getLSB(enPassantTargetBB);
-                unsetPiece(enPassantTarget + ((us == WHITE) ? SOUTH : NORTH));
-                setPiece(to, piece);
-            } else if (move.isCapture()) {
-                replacePiece(to, piece);
-            } else {
-                setPiece(to, piece);
+    Bitboard diagonal_sliders = occupancies().pieces[BISHOP] | occupancies().pieces[QUEEN];
+    Bitboard straight_sliders = occupancies().pieces[ROOK] | occupancies().pieces[QUEEN];
+    Bitboard attackers = getAttackersTo(to, occupancy) & occupancy;
+
+    while (true) {
+        depth++;
+        gain[depth] = PIECE_VALUES[attacker] - gain[depth - 1];
+
+        // stop if the result can no longer change sign for either side
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+            break;
+        }
+
+        // pinned pieces may not capture as long as their pinner is on the board
+        Bitboard side_attackers = attackers & getColorOccupancy(side);
+        if (gameState.pinners[!side] & occupancy) {
+            side_attackers &= ~gameState.blockers[side];
+        }
+        if (!side_attackers) {
+            break;
+        }
+
+        // capture with the least valuable attacker
+        for (attacker = PAWN; attacker <= KING; attacker++) {
+            if (side_attackers & occupancies().pieces[attacker]) {
+                break;
             }
         }
+        // the king may only capture if the square is not defended anymore
+        if (attacker == KING && (attackers & getColorOccupancy(!side) & ~side_attackers)) {
+            break;
+        }
+        Bitboard capturer = side_attackers & occupancies().pieces[attacker];
+        occupancy ^= bb::getBitboard(bb::getLSB(capturer));
+
+        // uncover sliders that were behind the capturing piece
+        if (attacker == PAWN || attacker == BISHOP || attacker == QUEEN) {
+            attackers |= attacks::getPieceAttacks<BISHOP>(to, occupancy) & diagonal_sliders;
+        }
+        if (attacker == ROOK || attacker == QUEEN) {
+            attackers |= attacks::getPieceAttacks<ROOK>(to, occupancy) & straight_sliders;
+        }
+        attackers &= occupancy;
+        side = !side;
     }
 
-    // store en passant target in the new game state
-    if (move.isDoublePawnPush()) {
-        next_game_state.en_passant_target = (us == WHITE) ? bb::getBitboard(from + NORTH) : bb::getBitboard(from + SOUTH);
-    } else {
-        next_game_state.en_passant_target = 0ULL;
+    // negamax the swap list back to the initial move
+    while (--depth) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
     }
+    return gain[0] >= threshold;
+}
 
-    // withdraw all castling rights if king moves (this is also done when actually castling, which is correct)
-    if (type_of(piece) == KING) {
-        next_game_state.castling_rights &= ~(us & ANY_CASTLING);
+bool Board::isDraw() const {
+    const GameState& gameState = state();
+    if (gameState.halfmove_clock >= 100) {
+        return true;
     }
 
-    // withdraw castling rights if rook moves away from start square
-    if (type_of(piece) == ROOK) {
-        if (from == H1 || from == H8) {
-            next_game_state.castling_rights &= ~(us & KINGSIDE_CASTLING);
-        } else if (from == A1 || from == A8) {
-            next_game_state.castling_rights &= ~(us & QUEENSIDE_CASTLING);
+    // positions can only repeat since the last irreversible move, and only
+    // with the same side to move, a null move is no move of the game and
+    // ends the scan as well
+    int first_ply = std::max(0, ply_ - std::min(gameState.halfmove_clock, gameState.plies_from_null));
+    for (int ply = ply_ - 4; ply >= first_ply; ply -= 2) {
+        if (state(ply).key == gameState.key) {
+            return true;
         }
     }
+    return false;
+}
+
+bool Board::isInCheck(Color color) const {
+    if (color == getSideToMove()) {
+        return state().checkers;
+    }
+    Square kingSquare = getKingSquare(color);
+    return isAttackedBy(kingSquare, !color);
+}
+
+void Board::movePiece(Square from, Square to) {
+    Piece piece = pieces()[from];
+    Bitboard from_to = bb::getBitboard(from) | bb::getBitboard(to);
+    occupancies().pieces[type_of(piece)] ^= from_to;
+    occupancies().colors[color_of(piece)] ^= from_to;
+    occupancies().pieces[NO_PIECE_TYPE] ^= from_to;
+    pieces()[to] = piece;
+    pieces()[from] = NO_PIECE;
+    accumulator().score += psqt::getScore(piece, to);
+    accumulator().score -= psqt::getScore(piece, from);
+}
+
+#ifdef USE_ATTACK_MAPS
+/* @brief Get all squares whose occupancy is changed by a move.
+ * @tparam TColor The side that makes the move.
+ * @tparam TFlag The flag of the move.
+ * @param move The move.
+ * @return A bitboard of the squares that are left, entered or cleared. */
+template <Color TColor, MoveFlag TFlag>
+static Bitboard getChangedSquares(Move move) {
+    constexpr Direction up = (TColor == WHITE) ? NORTH : SOUTH;
+    Bitboard changed = bb::getBitboard(move.getFrom()) | bb::getBitboard(move.getTo());
+    if constexpr (TFlag == EN_PASSANT_CAPTURE) {
+        changed |= bb::getBitboard(move.getTo() - up);
+    }
+    if constexpr (TFlag == KINGSIDE_CASTLE) {
+        changed |= (TColor == WHITE) ? bb::getBitboard(H1) | bb::getBitboard(F1)
+                                     : bb::getBitboard(H8) | bb::getBitboard(F8);
+    }
+    if constexpr (TFlag == QUEENSIDE_CASTLE) {
+        changed |= (TColor == WHITE) ? bb::getBitboard(A1) | bb::getBitboard(D1)
+                                     : bb::getBitboard(A8) | bb::getBitboard(D8);
+    }
+    return changed;
+}
+#endif
+
+void Board::refreshNetworkAccumulator() {
+    for (Color perspective : {WHITE, BLACK}) {
+        nnue::refresh(network_accumulator_, *this, perspective);
+    }
+}
+
+template <Color TColor, MoveFlag TFlag, bool TUnmake>
+void Board::updateNetworkAccumulator(Move move) {
+    constexpr Direction up = (TColor == WHITE) ? NORTH : SOUTH;
+    constexpr bool is_castling = (TFlag == KINGSIDE_CASTLE || TFlag == QUEENSIDE_CASTLE);
+    constexpr bool is_capture = TFlag & CAPTURE;
+    constexpr bool is_promotion = TFlag & KNIGHT_PROMOTION;
+
+    // the accumulator of an earlier network cannot be updated
+    if (network_accumulator_.generation != nnue::getGeneration()) {
+        refreshNetworkAccumulator();
+        return;
+    }
+
+    // the pieces are read from the board, which has the moving piece on the
+    // target square after making and on the origin square after unmaking
+    Square from = move.getFrom();
+    Square to = move.getTo();
+    Square captured_square = (TFlag == EN_PASSANT_CAPTURE) ? to - up : to;
+    Piece placed = is_promotion ? make_piece(TColor, (TFlag & 0b0011) + KNIGHT) : pieces()[TUnmake ? from : to];
+    Piece piece = is_promotion ? make_piece(TColor, PAWN) : placed;
+    Piece captured = is_capture ? state(TUnmake ? ply_ + 1 : ply_).captured : static_cast<Piece>(NO_PIECE);
+    bool is_king_move = type_of(piece) == KING;
+
+    for (Color perspective : {WHITE, BLACK}) {
+        // the kings are no features, but all features of a side change with
+        // the square of its own king
+        if (is_king_move && perspective == TColor) {
+            nnue::refresh(network_accumulator_, *this, perspective);
+            continue;
+        }
+        Square king = getKingSquare(perspective);
+        nnue::Changes changes;
+        if (!is_king_move) {
+            changes.remove(nnue::getFeature(perspective, king, piece, from));
+            changes.add(nnue::getFeature(perspective, king, placed, to));
+        }
+        if constexpr (is_capture) {
+            changes.remove(nnue::getFeature(perspective, king, captured, captured_square));
+        }
+        if constexpr (is_castling) {
+            constexpr Square rook_from = (TColor == WHITE) ? ((TFlag == KINGSIDE_CASTLE) ? H1 : A1)
+                                                           : ((TFlag == KINGSIDE_CASTLE) ? H8 : A8);
+            constexpr Square rook_to = (TColor == WHITE) ? ((TFlag == KINGSIDE_CASTLE) ? F1 : D1)
+                                                         : ((TFlag == KINGSIDE_CASTLE) ? F8 : D8);
+            constexpr Piece rook = make_piece(TColor, ROOK);
+            changes.remove(nnue::getFeature(perspective, king, rook, rook_from));
+            changes.add(nnue::getFeature(perspective, king, rook, rook_to));
+        }
 
-    // withdraw castling rights if rook is captured                             // NOTE: this seems to have a bug!
-    if (type_of(captured) == ROOK) {
-
-        // NOTE: This should be equivalent to what comes below. However, it fails
-        //       for perft position 4 at depth 4.
-        /*if (to == H1 || to == H8) {
-            next_game_state.castlingRights &= ~(them & KINGSIDE_CASTLING);
-        } else if (to == A1 || to == A8) {
-            next_game_state.castlingRights &= ~(them & QUEENSIDE_CASTLING);
-        }*/
-
-        if (us == BLACK && to == H1) {
-            next_game_state.castling_rights &= ~WHITE_KINGSIDE_CASTLING;
-        } else if (us == BLACK && to == A1) {
-            next_game_state.castling_rights &= ~WHITE_QUEENSIDE_CASTLING;
-        } else if (us == WHITE && to == H8) {
-            next_game_state.castling_rights &= ~BLACK_KINGSIDE_CASTLING;
-        } else if (us == WHITE && to == A8) {
-            next_game_state.castling_rights &= ~BLACK_QUEENSIDE_CASTLING;
+        // unmaking adds what making has removed and vice versa
+        if constexpr (TUnmake) {
+            std::swap(changes.added, changes.removed);
+            std::swap(changes.n_added, changes.n_removed);
         }
+        nnue::update(network_accumulator_, perspective, changes);
+    }
+}
+
+template <Color TColor, MoveFlag TFlag>
+void Board::makeMove(Move move) {
+    constexpr Color them = !TColor;
+    constexpr Direction up = (TColor == WHITE) ? NORTH : SOUTH;
+    constexpr bool is_castling = (TFlag == KINGSIDE_CASTLE || TFlag == QUEENSIDE_CASTLE);
+    constexpr bool is_capture = TFlag & CAPTURE;
+    constexpr bool is_promotion = TFlag & KNIGHT_PROMOTION;
+    constexpr bool is_pawn_move = (TFlag == DOUBLE_PAWN_PUSH || TFlag == EN_PASSANT_CAPTURE || is_promotion);
+    assert(getSideToMove() == TColor && move.getFlag() == TFlag);
+
+    Square from = move.getFrom();
+    Square to = move.getTo();
+    Square captured_square = (TFlag == EN_PASSANT_CAPTURE) ? to - up : to;
+    Piece piece = pieces()[from];
+    Piece captured = is_capture ? pieces()[captured_square] : static_cast<Piece>(NO_PIECE);
+    Piece placed = is_promotion ? make_piece(TColor, (TFlag & 0b0011) + KNIGHT) : piece;
+
+    // push a new game state onto the stack, with copy-make the whole board is
+    // copied along and modified in place
+    assert(ply_ + 1 < GAME_STATE_HISTORY_LENGTH);
+#ifdef USE_COPY_MAKE
+    history_[ply_ + 1] = history_[ply_];
+#endif
+    const GameState& prev_game_state = state();
+    ply_++;
+    GameState& next_game_state = state();
+    next_game_state.captured = captured;
+    next_game_state.side_to_move = them;
+    next_game_state.en_passant_target = (TFlag == DOUBLE_PAWN_PUSH) ? bb::getBitboard(from + up) : 0ULL;
+    next_game_state.halfmove_clock = (is_capture || is_pawn_move || type_of(piece) == PAWN)
+                                   ? 0 : prev_game_state.halfmove_clock + 1;
+    next_game_state.plies_from_null = prev_game_state.plies_from_null + 1;
+
+    // withdraw castling rights if the king or a rook moves away or a rook is captured
+    next_game_state.castling_rights = prev_game_state.castling_rights
+                                    & ~(getAffectedCastlingRights(from) | getAffectedCastlingRights(to));
+
+    // update the keys for the side to move, the castling rights and the en passant file
+    Key key = prev_game_state.key ^ zobrist::getSideKey()
+            ^ zobrist::getCastlingKey(prev_game_state.castling_rights)
+            ^ zobrist::getCastlingKey(next_game_state.castling_rights);
+    Key pawn_key = prev_game_state.pawn_key;
+    Key material_key = prev_game_state.material_key;
+    if (prev_game_state.en_passant_target) {
+        key ^= zobrist::getEnPassantKey(bb::getLSB(prev_game_state.en_passant_target) % N_FILES);
+    }
+    if constexpr (TFlag == DOUBLE_PAWN_PUSH) {
+        key ^= zobrist::getEnPassantKey(to % N_FILES);
+    }
+
+    // remove the captured piece
+    if constexpr (is_capture) {
+        unsetPiece(captured_square);
+        key ^= zobrist::getPieceKey(captured, captured_square);
+        pawn_key ^= (type_of(captured) == PAWN) ? zobrist::getPieceKey(captured, captured_square) : 0ULL;
+        material_key ^= zobrist::getMaterialKey(captured, bb::count(getPieceOccupancy(type_of(captured), them)));
+    }
+
+    // move the piece, a promoting pawn is replaced by the new piece
+    if constexpr (is_promotion) {
+        unsetPiece(from);
+        setPiece(to, placed);
+        material_key ^= zobrist::getMaterialKey(piece, bb::count(getPieceOccupancy(PAWN, TColor)))
+                      ^ zobrist::getMaterialKey(placed, bb::count(getPieceOccupancy(type_of(placed), TColor)) - 1);
+    } else {
+        movePiece(from, to);
+    }
+    key ^= zobrist::getPieceKey(piece, from) ^ zobrist::getPieceKey(placed, to);
+    if constexpr (is_pawn_move) {
+        pawn_key ^= zobrist::getPieceKey(piece, from) ^ (is_promotion ? 0ULL : zobrist::getPieceKey(piece, to));
+    } else if constexpr (!is_castling) {
+        pawn_key ^= (type_of(piece) == PAWN) ? zobrist::getPieceKey(piece, from) ^ zobrist::getPieceKey(piece, to) : 0ULL;
+    }
+
+    // move the rook when castling
+    if constexpr (is_castling) {
+        constexpr Square rook_from = (TColor == WHITE) ? ((TFlag == KINGSIDE_CASTLE) ? H1 : A1)
+                                                       : ((TFlag == KINGSIDE_CASTLE) ? H8 : A8);
+        constexpr Square rook_to = (TColor == WHITE) ? ((TFlag == KINGSIDE_CASTLE) ? F1 : D1)
+                                                     : ((TFlag == KINGSIDE_CASTLE) ? F8 : D8);
+        constexpr Piece rook = make_piece(TColor, ROOK);
+        movePiece(rook_from, rook_to);
+        key ^= zobrist::getPieceKey(rook, rook_from) ^ zobrist::getPieceKey(rook, rook_to);
+    }
+
+    next_game_state.key = key;
+    next_game_state.pawn_key = pawn_key;
+    next_game_state.material_key = material_key;
+
+#ifdef USE_ATTACK_MAPS
+    updateAttackMaps(getChangedSquares<TColor, TFlag>(move));
+#endif
+
+    if (nnue::isLoaded()) {
+        updateNetworkAccumulator<TColor, TFlag, false>(move);
     }
 
-    // push new game state to stack
-    game_state_history_.push_back(next_game_state);
+    updateCheckInfo();
+
+#ifdef DEBUG_ZOBRIST
+    assert(getKey() == computeKey());
+    assert(getPawnKey() == computePawnKey());
+    assert(getMaterialKey() == computeMaterialKey());
+#endif
+#ifdef DEBUG_EVALUATION
+    assert(getAccumulator() == computeAccumulator());
+    assert(!nnue::isLoaded() || getNetworkAccumulator() == nnue::computeAccumulator(*this));
+#endif
 }
 
+template <Color TColor, MoveFlag TFlag>
 void Board::unmakeMove(Move move) {
+    assert(getSideToMove() == !TColor && move.getFlag() == TFlag);
+#ifdef USE_COPY_MAKE
+    // the board before the move is still on the stack
+    (void)move;
+    ply_--;
+#else
+    constexpr Direction up = (TColor == WHITE) ? NORTH : SOUTH;
+    constexpr bool is_castling = (TFlag == KINGSIDE_CASTLE || TFlag == QUEENSIDE_CASTLE);
+    constexpr bool is_capture = TFlag & CAPTURE;
+    constexpr bool is_promotion = TFlag & KNIGHT_PROMOTION;
 
-    // store and pop the game state introduced by the move to be unmade
-    GameState state = game_state_history_.back();
-    game_state_history_.pop_back();
+    // pop the game state introduced by the move to be unmade
+    Piece captured = state().captured;
+    ply_--;
+
+    Square from = move.getFrom();
+    Square to = move.getTo();
 
+    // move the piece back, a promoted piece is turned back into a pawn
+    if constexpr (is_promotion) {
+        unsetPiece(to);
+        setPiece(from, make_piece(TColor, PAWN));
+    } else {
+        movePiece(to, from);
+    }
+
+    // move the rook back when castling
+    if constexpr (is_castling) {
+        constexpr Square rook_from = (TColor == WHITE) ? ((TFlag == KINGSIDE_CASTLE) ? H1 : A1)
+                                                       : ((TFlag == KINGSIDE_CASTLE) ? H8 : A8);
+        constexpr Square rook_to = (TColor == WHITE) ? ((TFlag == KINGSIDE_CASTLE) ? F1 : D1)
+                                                     : ((TFlag == KINGSIDE_CASTLE) ? F8 : D8);
+        movePiece(rook_to, rook_from);
+    }
+
+    // restore the captured piece, which is behind the target square for en passant captures
+    if constexpr (is_capture) {
+        setPiece((TFlag == EN_PASSANT_CAPTURE) ? to - up : to, captured);
+    }
+#endif
+
+#ifdef USE_ATTACK_MAPS
+    updateAttackMaps(getChangedSquares<TColor, TFlag>(move));
+#endif
+
+    if (nnue::isLoaded()) {
+        updateNetworkAccumulator<TColor, TFlag, true>(move);
+    }
+
+#ifdef DEBUG_EVALUATION
+    assert(getAccumulator() == computeAccumulator());
+    assert(!nnue::isLoaded() || getNetworkAccumulator() == nnue::computeAccumulator(*this));
+#endif
+}
+
+/* @brief Make or unmake a move using the function specialised for the given
+ *  side and move flag.
+ * @tparam TColor The side that makes the move.
+ * @tparam TFlag The flag of the move.
+ * @tparam TUnmake Whether to unmake instead of make the move.
+ * @param board The board to make the move on.
+ * @param move The move to be made or unmade. */
+template <Color TColor, MoveFlag TFlag, bool TUnmake>
+static void playMove(Board& board, Move move) {
+    if constexpr (TUnmake) {
+        board.unmakeMove<TColor, TFlag>(move);
+    } else {
+        board.makeMove<TColor, TFlag>(move);
+    }
+}
+
+/* @brief Dispatch a move to the function specialised for its flag.
+ * @tparam TColor The side that makes the move.
+ * @tparam TUnmake Whether to unmake instead of make the move.
+ * @param board The board to make the move on.
+ * @param move The move to be made or unmade. */
+template <Color TColor, bool TUnmake>
+static void dispatchMove(Board& board, Move move) {
+    switch (move.getFlag()) {
+        case QUIET:                     playMove<TColor, QUIET, TUnmake>(board, move); break;
+        case DOUBLE_PAWN_PUSH:          playMove<TColor, DOUBLE_PAWN_PUSH, TUnmake>(board, move); break;
+        case KINGSIDE_CASTLE:           playMove<TColor, KINGSIDE_CASTLE, TUnmake>(board, move); break;
+        case QUEENSIDE_CASTLE:          playMove<TColor, QUEENSIDE_CASTLE, TUnmake>(board, move); break;
+        case CAPTURE:                   playMove<TColor, CAPTURE, TUnmake>(board, move); break;
+        case EN_PASSANT_CAPTURE:        playMove<TColor, EN_PASSANT_CAPTURE, TUnmake>(board, move); break;
+        case KNIGHT_PROMOTION:          playMove<TColor, KNIGHT_PROMOTION, TUnmake>(board, move); break;
+        case BISHOP_PROMOTION:          playMove<TColor, BISHOP_PROMOTION, TUnmake>(board, move); break;
+        case ROOK_PROMOTION:            playMove<TColor, ROOK_PROMOTION, TUnmake>(board, move); break;
+        case QUEEN_PROMOTION:           playMove<TColor, QUEEN_PROMOTION, TUnmake>(board, move); break;
+        case KNIGHT_PROMOTION_CAPTURE:  playMove<TColor, KNIGHT_PROMOTION_CAPTURE, TUnmake>(board, move); break;
+        case BISHOP_PROMOTION_CAPTURE:  playMove<TColor, BISHOP_PROMOTION_CAPTURE, TUnmake>(board, move); break;
+        case ROOK_PROMOTION_CAPTURE:    playMove<TColor, ROOK_PROMOTION_CAPTURE, TUnmake>(board, move); break;
+        case QUEEN_PROMOTION_CAPTURE:   playMove<TColor, QUEEN_PROMOTION_CAPTURE, TUnmake>(board, move); break;
+        default:                          assert(false);
+    }
+}
+
+void Board::makeMove(Move move) {
+    if (getSideToMove() == WHITE) {
+        dispatchMove<WHITE, false>(*this, move);
+    } else {
+        dispatchMove<BLACK, false>(*this, move);
+    }
+}
+
+void Board::unmakeMove(Move move) {
+    // the move has been made by the side that is not to move now
+    if (getSideToMove() == BLACK) {
+        dispatchMove<WHITE, true>(*this, move);
+    } else {
+        dispatchMove<BLACK, true>(*this, move);
+    }
+}
+
+void Board::makeNullMove() {
+    assert(!getCheckers());
+    assert(ply_ + 1 < GAME_STATE_HISTORY_LENGTH);
+#ifdef USE_COPY_MAKE
+    history_[ply_ + 1] = history_[ply_];
+#else
+    game_state_history_[ply_ + 1] = game_state_history_[ply_];
+#endif
+    ply_++;
+
+    // only the side to move and the en passant target change, no piece moves
+    GameState& next_game_state = state();
+    if (next_game_state.en_passant_target) {
+        next_game_state.key ^= zobrist::getEnPassantKey(bb::getLSB(next_game_state.en_passant_target) % N_FILES);
+    }
+    next_game_state.key ^= zobrist::getSideKey();
+    next_game_state.en_passant_target = 0ULL;
+    next_game_state.side_to_move = !next_game_state.side_to_move;
+    next_game_state.captured = NO_PIECE;
+    next_game_state.halfmove_clock++;
+    next_game_state.plies_from_null = 0;
+    updateCheckInfo();
+
+#ifdef DEBUG_ZOBRIST
+    assert(getKey() == computeKey());
+#endif
+}
+
+void Board::unmakeNullMove() {
+    ply_--;
+}
+
+void Board::discardHistory() {
+    int first_ply = std::max(0, ply_ - state().halfmove_clock);
+    if (first_ply == 0) {
+        return;
+    }
+#ifdef USE_COPY_MAKE
+    std::copy(&history_[first_ply], &history_[ply_ + 1], &history_[0]);
+#else
+    std::copy(&game_state_history_[first_ply], &game_state_history_[ply_ + 1], &game_state_history_[0]);
+#endif
+    ply_ -= first_ply;
+}
+
+bool Board::isPseudoLegal(Move move) const {
     Color us = getSideToMove();
-    Color them = !us;
     Square from = move.getFrom();
     Square to = move.getTo();
-    Piece piece = pieces_[to];
-    Piece captured = state.captured;
+    Piece piece = pieces()[from];
+    if (piece == NO_PIECE || color_of(piece) != us || from == to) {
+        return false;
+    }
+    PieceType piece_type = type_of(piece);
+    Bitboard occupancy = getTotalOccupancy();
 
+    // castling needs the right and free squares between king and rook, the
+    // attacks on the squares the king passes are tested by isLegal
     if (move.isCastling()) {
-        assert(type_of(piece) == KING);    // moving piece must be the king
+        CastlingRight cr = us & ((move.getFlag() == KINGSIDE_CASTLE) ? KINGSIDE_CASTLING : QUEENSIDE_CASTLING);
+        return piece_type == KING && canCastle(cr) && !isCastlingBlocked(cr) && to == CASTLING_KING_GOAL_SQUARE[cr];
+    }
+    if (move.isEnPassantCapture()) {
+        return piece_type == PAWN && bb::get(state().en_passant_target, to)
+            && bb::get(attacks::getPawnAttacks(from, us), to);
+    }
 
-        // determine rook target square
-        Square rookFrom = get_square(us * RANK_8, (from < to) ? FILE_H : FILE_A);
-        Square rookTo = (from < to) ? to + WEST : to + EAST;
+    // captures need an enemy piece on the target square, all other moves an
+    // empty one
+    if (move.isCapture() ? !bb::get(getColorOccupancy(!us), to) : bb::get(occupancy, to)) {
+        return false;
+    }
 
-        // move king from to to from square
-        unsetPiece(to);
-        setPiece(from, piece);
-        unsetPiece(rookTo);
-        setPiece(rookFrom, make_piece(us, ROOK));
-    } else {
-        if (move.isPromotion()) {
-            // handle captures
-            if (move.isCapture()) {
-                replacePiece(to, captured);
-            } else {
-                unsetPiece(to);
-            }
-            // place a pawn on the move's original square
-            setPiece(from, make_piece(us, PAWN));
-        } else {
-            // restore en passant captures
-            if (move.isEnPassantCapture()) {
-                // put a pawn back on the field, one in front of the capture field
-                setPiece((us == WHITE) ? (to + SOUTH) : (to + NORTH), make_piece(them, PAWN));
-                unsetPiece(to);
-            } else if (move.isCapture()) {
-                // handle captures
-                replacePiece(to, captured);
-            } else {
-                unsetPiece(to);
-            }
-            // place the moving piece on the move's original square
-            setPiece(from, piece);
+    if (piece_type == PAWN) {
+        Direction up = (us == WHITE) ? NORTH : SOUTH;
+        if (move.isPromotion() != bb::get((us == WHITE) ? RANK_8_BB : RANK_1_BB, to)) {
+            return false;
         }
+        if (move.isCapture()) {
+            return (move.isPromotion() || move.getFlag() == CAPTURE) && bb::get(attacks::getPawnAttacks(from, us), to);
+        }
+        if (move.isDoublePawnPush()) {
+            return bb::get((us == WHITE) ? RANK_2_BB : RANK_7_BB, from) && to == from + 2 * up
+                && !bb::get(occupancy, from + up);
+        }
+        return to == from + up;
+    }
+
+    // all other pieces only make plain moves and captures
+    if (move.getFlag() != QUIET && move.getFlag() != CAPTURE) {
+        return false;
     }
+    Bitboard attacks;
+    switch (piece_type) {
+        case KNIGHT: attacks = attacks::getPieceAttacks<KNIGHT>(from, occupancy); break;
+        case BISHOP: attacks = attacks::getPieceAttacks<BISHOP>(from, occupancy); break;
+        case ROOK: attacks = attacks::getPieceAttacks<ROOK>(from, occupancy); break;
+        case QUEEN: attacks = attacks::getPieceAttacks<QUEEN>(from, occupancy); break;
+        default: attacks = attacks::getPieceAttacks<KING>(from, occupancy); break;
+    }
+    return bb::get(attacks, to);
 }
 
-bool Board::isLegal(Move move) {
-    // various situations to cover:
-    // 1. if the king is moving: test whether the goal square is under attack
-    // 2. if castling, ensure that none of the squares the king passes are under attack
-    // 3. if en-passant capturing, ensure that the king does not end up in check
-    // 4. for all other moves, test whether they unblock a sliding piece's attack to the king
-    
-    // what if the king is in check? could/should add a separate move GENERATION for this case 
+bool Board::isLegal(Move move) const {
+    Color us = getSideToMove();
+    Color them = !us;
+    Square from = move.getFrom();
+    Square to = move.getTo();
+    Bitboard their_pieces = occupancies().colors[them];
+
+    // when castling, none of the squares the king passes may be under attack
+    if (move.isCastling()) {
+        Direction dir = (to > from) ? EAST : WEST;
+        for (Square square = from; square != to + dir; square += dir) {
+            if (isAttackedBy(square, them)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the king may not move to an attacked square, sliders attack through the
+    // square the king is leaving
+    if (type_of(pieces()[from]) == KING) {
+        Bitboard occupancy = getTotalOccupancy() ^ bb::getBitboard(from);
+        return !(getAttackersTo(to, occupancy) & their_pieces);
+    }
 
-    return true;
+    // a piece that is not pinned can make any move unless the king is in
+    // check, a pinned one has to stay on the line between pinner and king
+    Square king_square = getKingSquare(us);
+    if (!move.isEnPassantCapture() && !state().checkers) {
+        return !bb::get(state().blockers[us], from) || bb::get(attacks::getLine(king_square, from), to);
+    }
+
+    // for all other moves, the king may not be attacked after the move, except
+    // by the piece that is captured by the move
+    Square captured_square = move.isEnPassantCapture() ? to + ((us == WHITE) ? SOUTH : NORTH) : to;
+    Bitboard captured = bb::getBitboard(captured_square);
+    Bitboard occupancy = (getTotalOccupancy() ^ bb::getBitboard(from) ^ (captured & getTotalOccupancy())) | bb::getBitboard(to);
+    return !(getAttackersTo(king_square, occupancy) & their_pieces & ~captured);
 }
 
 void Board::print() {
@@ -415,7 +1095,7 @@ void Board::print() {
         std::cout << " " << rank + 1 << "  ";
         for (int file = 0; file < 8; file++) {
             int square = (rank * 8 + file);
-            Piece piece = pieces_[square];
+            Piece piece = pieces()[square];
             std::cout << " " << PIECE_SYMBOLS[piece];
         }
         std::cout << std::endl;
@@ -449,3 +1129,61 @@ void Board::print() {
 
     std::cout << std::endl;
 }
+
+// explicit instantiations of the specialised make and unmake functions
+template void Board::makeMove<WHITE, QUIET>(Move);
+template void Board::unmakeMove<WHITE, QUIET>(Move);
+template void Board::makeMove<WHITE, DOUBLE_PAWN_PUSH>(Move);
+template void Board::unmakeMove<WHITE, DOUBLE_PAWN_PUSH>(Move);
+template void Board::makeMove<WHITE, KINGSIDE_CASTLE>(Move);
+template void Board::unmakeMove<WHITE, KINGSIDE_CASTLE>(Move);
+template void Board::makeMove<WHITE, QUEENSIDE_CASTLE>(Move);
+template void Board::unmakeMove<WHITE, QUEENSIDE_CASTLE>(Move);
+template void Board::makeMove<WHITE, CAPTURE>(Move);
+template void Board::unmakeMove<WHITE, CAPTURE>(Move);
+template void Board::makeMove<WHITE, EN_PASSANT_CAPTURE>(Move);
+template void Board::unmakeMove<WHITE, EN_PASSANT_CAPTURE>(Move);
+template void Board::makeMove<WHITE, KNIGHT_PROMOTION>(Move);
+template void Board::unmakeMove<WHITE, KNIGHT_PROMOTION>(Move);
+template void Board::makeMove<WHITE, BISHOP_PROMOTION>(Move);
+template void Board::unmakeMove<WHITE, BISHOP_PROMOTION>(Move);
+template void Board::makeMove<WHITE, ROOK_PROMOTION>(Move);
+template void Board::unmakeMove<WHITE, ROOK_PROMOTION>(Move);
+template void Board::makeMove<WHITE, QUEEN_PROMOTION>(Move);
+template void Board::unmakeMove<WHITE, QUEEN_PROMOTION>(Move);
+template void Board::makeMove<WHITE, KNIGHT_PROMOTION_CAPTURE>(Move);
+template void Board::unmakeMove<WHITE, KNIGHT_PROMOTION_CAPTURE>(Move);
+template void Board::makeMove<WHITE, BISHOP_PROMOTION_CAPTURE>(Move);
+template void Board::unmakeMove<WHITE, BISHOP_PROMOTION_CAPTURE>(Move);
+template void Board::makeMove<WHITE, ROOK_PROMOTION_CAPTURE>(Move);
+template void Board::unmakeMove<WHITE, ROOK_PROMOTION_CAPTURE>(Move);
+template void Board::makeMove<WHITE, QUEEN_PROMOTION_CAPTURE>(Move);
+template void Board::unmakeMove<WHITE, QUEEN_PROMOTION_CAPTURE>(Move);
+template void Board::makeMove<BLACK, QUIET>(Move);
+template void Board::unmakeMove<BLACK, QUIET>(Move);
+template void Board::makeMove<BLACK, DOUBLE_PAWN_PUSH>(Move);
+template void Board::unmakeMove<BLACK, DOUBLE_PAWN_PUSH>(Move);
+template void Board::makeMove<BLACK, KINGSIDE_CASTLE>(Move);
+template void Board::unmakeMove<BLACK, KINGSIDE_CASTLE>(Move);
+template void Board::makeMove<BLACK, QUEENSIDE_CASTLE>(Move);
+template void Board::unmakeMove<BLACK, QUEENSIDE_CASTLE>(Move);
+template void Board::makeMove<BLACK, CAPTURE>(Move);
+template void Board::unmakeMove<BLACK, CAPTURE>(Move);
+template void Board::makeMove<BLACK, EN_PASSANT_CAPTURE>(Move);
+template void Board::unmakeMove<BLACK, EN_PASSANT_CAPTURE>(Move);
+template void Board::makeMove<BLACK, KNIGHT_PROMOTION>(Move);
+template void Board::unmakeMove<BLACK, KNIGHT_PROMOTION>(Move);
+template void Board::makeMove<BLACK, BISHOP_PROMOTION>(Move);
+template void Board::unmakeMove<BLACK, BISHOP_PROMOTION>(Move);
+template void Board::makeMove<BLACK, ROOK_PROMOTION>(Move);
+template void Board::unmakeMove<BLACK, ROOK_PROMOTION>(Move);
+template void Board::makeMove<BLACK, QUEEN_PROMOTION>(Move);
+template void Board::unmakeMove<BLACK, QUEEN_PROMOTION>(Move);
+template void Board::makeMove<BLACK, KNIGHT_PROMOTION_CAPTURE>(Move);
+template void Board::unmakeMove<BLACK, KNIGHT_PROMOTION_CAPTURE>(Move);
+template void Board::makeMove<BLACK, BISHOP_PROMOTION_CAPTURE>(Move);
+template void Board::unmakeMove<BLACK, BISHOP_PROMOTION_CAPTURE>(Move);
+template void Board::makeMove<BLACK, ROOK_PROMOTION_CAPTURE>(Move);
+template void Board::unmakeMove<BLACK, ROOK_PROMOTION_CAPTURE>(Move);
+template void Board::makeMove<BLACK, QUEEN_PROMOTION_CAPTURE>(Move);
+template void Board::unmakeMove<BLACK, QUEEN_PROMOTION_CAPTURE>(Move);
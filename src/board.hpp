@@ -1,6 +1,7 @@
 #ifndef BOARD_HPP
 #define BOARD_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <ctype.h>
@@ -11,8 +12,11 @@
 #include "bitboard.hpp"
 #include "exceptions.hpp"
 #include "move.hpp"
+#include "nnue.hpp"
+#include "psqt.hpp"
 #include "types.hpp"
 #include "utils.hpp"
+#include "zobrist.hpp"
 
 // standard initial board configuration
 const std::string INITIAL_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
@@ -24,33 +28,143 @@ struct GameState {
     uint8_t castling_rights;
     Piece captured;
     Color side_to_move;
+    uint16_t halfmove_clock;    // plies since the last capture or pawn move
+    uint16_t plies_from_null = 0;   // plies since the last null move
+    Key key = 0;            // Zobrist key of the full position
+    Key pawn_key = 0;       // Zobrist key of the pawns only
+    Key material_key = 0;   // Zobrist key of the piece counts
+
+    // check information, computed once per position when a move is made
+    Bitboard checkers = 0;                      // enemy pieces giving check to the side to move
+    Bitboard blockers[N_COLORS] = {};           // single pieces between each king and an enemy slider
+    Bitboard pinners[N_COLORS] = {};            // sliders of each color pinning an enemy piece to its king
+    Bitboard check_squares[N_PIECE_TYPES] = {}; // squares from which the side to move gives check
 };
 
 const GameState INITIAL_GAME_STATE = GameState {
-    0ULL,                   // no en passant square
-    0b00001111,             // full castling rights for both sides
-    NO_PIECE,               // no captured piece
-    WHITE,                  // white begins
+    .en_passant_target = 0ULL,      // no en passant square
+    .castling_rights = 0b00001111,  // full castling rights for both sides
+    .captured = NO_PIECE,           // no captured piece
+    .side_to_move = WHITE,          // white begins
+    .halfmove_clock = 0,            // no plies played yet
 };
 
+// occupancy bitboards of both colors by piece type, intersected with the color
+// occupancy for the pieces of one side, which fits into a single cache line
 struct OccupancyBitboards {
     public:
-    Bitboard pieces[N_COLORS][N_PIECE_TYPES];   // piece-wise occupancy         // NOTE: N_PIECE_TYPES is 7, one is not needed
+    Bitboard pieces[N_PIECE_TYPES];             // piece-wise occupancy, total occupancy at NO_PIECE_TYPE
     Bitboard colors[N_COLORS];                  // color-wise occupancy
-    Bitboard all;                               // total occupancy
 };
 
+// material and piece-square sums of the evaluation, updated incrementally
+// whenever a piece is set, unset or moved
+struct EvalAccumulator {
+    public:
+    psqt::Score score;      // sum over the white pieces minus sum over the black pieces
+
+    bool operator==(const EvalAccumulator& other) const = default;
+};
+
+#ifdef USE_ATTACK_MAPS
+// attacks of all pieces, updated incrementally whenever pieces are moved
+struct AttackMaps {
+    public:
+    Bitboard attacks_from[N_SQUARES];           // squares attacked by the piece on each square
+    Bitboard attackers_to[N_SQUARES];           // pieces of both colors attacking each square
+    Bitboard by_color[N_COLORS];                // squares attacked by each side
+};
+#endif
+
+#ifdef USE_COPY_MAKE
+// complete board representation, copied to the next stack entry on every move
+struct BoardState {
+    public:
+    OccupancyBitboards occupancies;
+    Piece pieces[N_SQUARES];
+    EvalAccumulator accumulator;
+    GameState game_state;
+};
+#endif
+
 class Board {
     private:
 
+#ifdef USE_COPY_MAKE
+    /* Stack containing a full copy of the board for each ply, unmaking a move
+       only requires dropping the topmost entry. */
+    BoardState history_[GAME_STATE_HISTORY_LENGTH];
+#else
     /* Bitboards for occupancy representation. */
     OccupancyBitboards occupancies_;
 
     /* Pieces by square. */
     Piece pieces_[N_SQUARES];
 
-    /* Stack containing the game state history. */
-    std::vector<GameState> game_state_history_;
+    /* Incrementally updated sums of the evaluation. */
+    EvalAccumulator accumulator_;
+
+    /* Stack containing the game state history, unmaking a move restores the
+       pieces and pops the topmost entry. */
+    GameState game_state_history_[GAME_STATE_HISTORY_LENGTH];
+#endif
+
+    /* Index of the current entry of the history stack. */
+    int ply_;
+
+    /* First layer of the network, which like the attack maps is not part of
+       the history and is updated on both making and unmaking a move. */
+    nnue::Accumulator network_accumulator_;
+
+    /* @brief Update the first layer of the network by the features changed
+     *  by a move, or recompute it if the king of a side has moved. Called
+     *  after the pieces have been moved, and only while a network is loaded.
+     * @tparam TColor The side that makes the move.
+     * @tparam TFlag The flag of the move.
+     * @tparam TUnmake Whether the move has been unmade instead of made.
+     * @param move The move. */
+    template <Color TColor, MoveFlag TFlag, bool TUnmake>
+    void updateNetworkAccumulator(Move move);
+
+    /* @brief Recompute the first layer of the network for both sides. */
+    void refreshNetworkAccumulator();
+
+#ifdef USE_ATTACK_MAPS
+    /* Attack maps of the current board, which are not part of the history
+       and are updated on both making and unmaking a move. */
+    AttackMaps attack_maps_;
+
+    /* @brief Recompute the attacks of all pieces standing on one of the given
+     *  squares, before or after a move, and of all sliders passing them.
+     * @param changed The squares whose occupancy has changed. */
+    void updateAttackMaps(Bitboard changed);
+#endif
+
+    /* @brief Compute the check information of the current position and store
+     *  it in the current game state. */
+    void updateCheckInfo();
+
+#ifdef USE_COPY_MAKE
+    OccupancyBitboards& occupancies() { return history_[ply_].occupancies; }
+    const OccupancyBitboards& occupancies() const { return history_[ply_].occupancies; }
+    Piece* pieces() { return history_[ply_].pieces; }
+    const Piece* pieces() const { return history_[ply_].pieces; }
+    EvalAccumulator& accumulator() { return history_[ply_].accumulator; }
+    const EvalAccumulator& accumulator() const { return history_[ply_].accumulator; }
+    GameState& state() { return history_[ply_].game_state; }
+    const GameState& state() const { return history_[ply_].game_state; }
+    const GameState& state(int ply) const { return history_[ply].game_state; }
+#else
+    OccupancyBitboards& occupancies() { return occupancies_; }
+    const OccupancyBitboards& occupancies() const { return occupancies_; }
+    Piece* pieces() { return pieces_; }
+    const Piece* pieces() const { return pieces_; }
+    EvalAccumulator& accumulator() { return accumulator_; }
+    const EvalAccumulator& accumulator() const { return accumulator_; }
+    GameState& state() { return game_state_history_[ply_]; }
+    const GameState& state() const { return game_state_history_[ply_]; }
+    const GameState& state(int ply) const { return game_state_history_[ply]; }
+#endif
     
     public:
     Board(const std::string& fen = INITIAL_FEN);
@@ -68,6 +182,46 @@ class Board {
     bool isCastlingBlocked(CastlingRight cr) const;
     Color getSideToMove() const;
 
+    Key getKey() const;
+    Key getPawnKey() const;
+    Key getMaterialKey() const;
+
+    /* @brief Compute the Zobrist key of the current position from scratch.
+     *  During play, the key is maintained incrementally, use getKey instead.
+     * @return The 64-bit key of the position. */
+    Key computeKey() const;
+
+    /* @brief Compute the Zobrist key of the pawn structure from scratch.
+     * @return The 64-bit key of all pawns on their squares. */
+    Key computePawnKey() const;
+
+    /* @brief Compute the Zobrist key of the material from scratch, which only
+     *  depends on the number of pieces of each kind on the board.
+     * @return The 64-bit key of the piece counts. */
+    Key computeMaterialKey() const;
+
+    /* @brief Get the material and piece-square sums of the evaluation, which
+     *  are maintained incrementally.
+     * @return The sums of the current position. */
+    const EvalAccumulator& getAccumulator() const { return accumulator(); }
+
+    /* @brief Compute the material and piece-square sums of the evaluation from
+     *  scratch. During play, the sums are maintained incrementally, use
+     *  getAccumulator instead.
+     * @return The sums of the current position. */
+    EvalAccumulator computeAccumulator() const;
+
+    /* @brief Get the first layer of the loaded network, which is maintained
+     *  incrementally while a network is loaded. It belongs to an earlier
+     *  network if it has been loaded after the board was set up and no move
+     *  has been made since.
+     * @return The accumulator of the current position. */
+    const nnue::Accumulator& getNetworkAccumulator() const { return network_accumulator_; }
+
+    /* Note: Setting, unsetting and moving single pieces does not update the
+       attack maps, the first layer of the network and the check information,
+       which is only done when making and unmaking moves. */
+
     void setPiece(Square square, Piece piece);
     void unsetPiece(Square square);
     void replacePiece(Square square, Piece piece);
@@ -78,12 +232,134 @@ class Board {
      * @return A boolean indicating whether the square is under attack. */
     bool isAttackedBy(Square square, Color color) const;
 
-    bool isInCheck(Color color);
+    /* @brief Get all pieces of both colors that attack the given square.
+     * @param square The attacked square.
+     * @param occupancy The occupancy to use for the sliding piece attacks.
+     * @return A bitboard of all attacking pieces. */
+    Bitboard getAttackersTo(Square square, Bitboard occupancy) const;
+
+    /* @brief Get all pieces of both colors that attack the given square on
+     *  the current board, which is a lookup when using attack maps.
+     * @param square The attacked square.
+     * @return A bitboard of all attacking pieces. */
+    Bitboard getAttackersTo(Square square) const;
+
+    /* @brief Get all squares attacked by the given side, including squares
+     *  occupied by its own pieces. This is a lookup when using attack maps
+     *  and is computed from scratch otherwise.
+     * @param color The attacking color.
+     * @return A bitboard of all attacked squares. */
+    Bitboard getAttackedSquares(Color color) const;
+
+    /* @brief Get all pieces that are the only blocker between the king of the
+     *  given color and an enemy sliding piece. Blockers of the king's own color
+     *  are pinned, enemy blockers can give a discovered check.
+     * @param color The color of the king.
+     * @return A bitboard of all blocking pieces of both colors. */
+    Bitboard getKingBlockers(Color color) const;
+
+    /* @brief Get all sliding pieces of the given color that pin an enemy piece
+     *  to the enemy king.
+     * @param color The color of the pinning pieces.
+     * @return A bitboard of all pinning pieces. */
+    Bitboard getPinners(Color color) const;
+
+    /* @brief Get all enemy pieces that give check to the side to move.
+     * @return A bitboard of all checking pieces. */
+    Bitboard getCheckers() const;
+
+    /* @brief Get the squares from which a piece of the side to move would
+     *  attack the enemy king.
+     * @param pieceType The type of the piece.
+     * @return A bitboard of all checking squares. */
+    Bitboard getCheckSquares(PieceType pieceType) const;
+
+    /* @brief Test whether a legal move of the side to move gives check,
+     *  either directly or by uncovering an attack of another piece.
+     * @param move The move to test.
+     * @return A boolean indicating whether the move gives check. */
+    bool givesCheck(Move move) const;
+
+    bool isInCheck(Color color) const;
 
+    /* @brief Test whether the position is drawn by the fifty move rule or by
+     *  repetition. A single repetition of an earlier position counts as a
+     *  draw, since the side to move could repeat it once more.
+     * @return A boolean indicating whether the position is drawn. */
+    bool isDraw() const;
+
+    /* @brief Static exchange evaluation of a move of the side to move. All
+     *  captures on the target square are resolved with the least valuable
+     *  attacker first, where both sides may stop capturing at any time.
+     *  Sliders behind other attackers join the exchange once uncovered.
+     * @param move The move to evaluate, which does not need to be a capture.
+     * @param threshold The minimum material gain in centipawns.
+     * @return A boolean indicating whether the move gains at least the
+     *  threshold. */
+    bool see(Move move, Value threshold = 0) const;
+
+    /* @brief Move a piece to an empty square.
+     * @param from The square of the piece.
+     * @param to The empty target square. */
+    void movePiece(Square from, Square to);
+
+    /* @brief Make a move of the side to move. The move is dispatched to the
+     *  function specialised for the side and the move's flag.
+     * @param move The move to be made. */
     void makeMove(Move move);
+
+    /* @brief Unmake the last move that has been made.
+     * @param move The move to be unmade. */
     void unmakeMove(Move move);
 
-    bool isLegal(Move move);
+    /* @brief Pass the turn to the other side without moving a piece, which is
+     *  used by the null move pruning of the search. Must not be called when
+     *  in check. */
+    void makeNullMove();
+
+    /* @brief Unmake the last move, which must have been a null move. */
+    void unmakeNullMove();
+
+    /* @brief Get the number of moves on the history stack, which bounds how
+     *  many more moves can be made before the stack is full.
+     * @return The index of the current entry of the history stack. */
+    int getPly() const { return ply_; }
+
+    /* @brief Drop all history entries before the last capture or pawn move,
+     *  which can no longer be repeated, and move the remaining entries to the
+     *  bottom of the stack. The dropped moves can no longer be unmade.
+     *  Long games stay within the stack as long as this is called between
+     *  the moves. */
+    void discardHistory();
+
+    /* @brief Make a move whose side and flag are known at compile time, which
+     *  avoids all branching on the move type.
+     * @tparam TColor The side to move.
+     * @tparam TFlag The flag of the move.
+     * @param move The move to be made. */
+    template <Color TColor, MoveFlag TFlag>
+    void makeMove(Move move);
+
+    /* @brief Unmake the last move, with side and flag known at compile time.
+     * @tparam TColor The side that has made the move.
+     * @tparam TFlag The flag of the move.
+     * @param move The move to be unmade. */
+    template <Color TColor, MoveFlag TFlag>
+    void unmakeMove(Move move);
+
+    /* @brief Test whether a move could have been generated as a pseudo-legal
+     *  move of the side to move, which allows playing moves that were found
+     *  in another position, like the hash move and the killer moves, without
+     *  generating all moves.
+     * @param move Any move, including an empty one.
+     * @return A boolean indicating whether the move is pseudo-legal. */
+    bool isPseudoLegal(Move move) const;
+
+    /* @brief Test whether a pseudo-legal move of the side to move is legal,
+     *  i.e. whether it does not leave the own king in check.
+     * @param move The pseudo-legal move to test.
+     * @return A boolean indicating whether the move is legal. */
+    bool isLegal(Move move) const;
 
     void print();
 };
@@ -0,0 +1,338 @@
+#include "endgame.hpp"
+
+namespace endgame {
+
+static int getFile(Square square) {
+    return square % N_FILES;
+}
+
+static int getRank(Square square) {
+    return square / N_FILES;
+}
+
+static int getDistance(Square a, Square b) {
+    return std::max(std::abs(getFile(a) - getFile(b)), std::abs(getRank(a) - getRank(b)));
+}
+
+static Bitboard getKingAttacks(Square square) {
+    return attacks::getPieceAttacks<KING>(square, 0ULL);
+}
+
+/* @brief Bonus for driving a king towards the edge of the board.
+ * @return A bonus from zero in the centre to 90 in the corners. */
+static Value pushToEdge(Square square) {
+    int rank_distance = std::min(getRank(square), N_RANKS - 1 - getRank(square));
+    int file_distance = std::min(getFile(square), N_FILES - 1 - getFile(square));
+    return 90 - (7 * file_distance * file_distance / 2 + 7 * rank_distance * rank_distance / 2);
+}
+
+/* @brief Bonus for driving a king towards the a1 or the h8 corner.
+ * @return The distance of the square from the long diagonal from a8 to h1. */
+static Value pushToCorner(Square square) {
+    return std::abs(N_FILES - 1 - getRank(square) - getFile(square));
+}
+
+// bonuses for bringing two pieces close to each other and apart
+static Value pushClose(int distance) {
+    return 140 - 20 * distance;
+}
+
+static Value pushAway(int distance) {
+    return 120 - pushClose(distance);
+}
+
+static Value getNonPawnMaterial(const Board& board, Color color) {
+    Value material = 0;
+    for (PieceType pieceType = KNIGHT; pieceType <= QUEEN; pieceType++) {
+        material += PIECE_VALUES[pieceType] * bb::count(board.getPieceOccupancy(pieceType, color));
+    }
+    return material;
+}
+
+/* @brief Test whether the weak side is stalemated. The specialised
+ *  evaluations are used in the quiescence search, which does not generate
+ *  quiet moves and therefore does not detect stalemates on its own. */
+static bool isStalemate(const Board& board, Color weak) {
+    return board.getSideToMove() == weak && !board.getCheckers() && MoveList(board).size() == 0;
+}
+
+Key getMaterialKey(const std::string& code, Color strong) {
+    const std::string symbols = "PNBRQK";
+    size_t weak_begin = code.find('K', 1);
+    int counts[N_PIECE_IDS] = {};
+    Key key = 0ULL;
+    for (size_t i = 0; i < code.size(); i++) {
+        Color color = (i < weak_begin) ? strong : Color(!strong);
+        Piece piece = make_piece(color, PieceType(symbols.find(code[i]) + 1));
+        key ^= zobrist::getMaterialKey(piece, counts[piece]++);
+    }
+    return key;
+}
+
+/* An endgame with a specialised evaluation, registered for both colors of the
+   stronger side. */
+struct Registration {
+    Key key;
+    EvaluationFunction evaluation;
+    Color strong;
+};
+
+static std::vector<Registration> registerEndgames() {
+    const std::pair<std::string, EvaluationFunction> endgames[] = {
+        {"KBNK", evaluateKBNK},
+        {"KPK", evaluateKPK},
+        {"KNNK", evaluateDraw},
+        {"KRKB", evaluateKRKB},
+        {"KRKN", evaluateKRKN},
+        {"KQKR", evaluateKQKR},
+    };
+    std::vector<Registration> registrations;
+    for (const auto& [code, evaluation] : endgames) {
+        for (Color strong : {WHITE, BLACK}) {
+            registrations.push_back(Registration{getMaterialKey(code, strong), evaluation, strong});
+        }
+    }
+    return registrations;
+}
+
+EvaluationFunction findEvaluation(Key material_key, Color& strong) {
+    static const std::vector<Registration> REGISTRATIONS = registerEndgames();
+    for (const Registration& registration : REGISTRATIONS) {
+        if (registration.key == material_key) {
+            strong = registration.strong;
+            return registration.evaluation;
+        }
+    }
+    return nullptr;
+}
+
+/* Note: The KPK bitbase holds every position of white king and pawn against
+ * black king, with the pawn on the files a to d, mirrored otherwise. It is
+ * computed by retrograde analysis: positions are classified as won or drawn
+ * right away where possible, and the remaining ones are classified from the
+ * results of their successors until nothing changes anymore. */
+
+const int KPK_SIZE = 2 * 24 * N_SQUARES * N_SQUARES;
+
+enum KPKResult : uint8_t {
+    KPK_INVALID = 0,
+    KPK_UNKNOWN = 1,
+    KPK_DRAW = 2,
+    KPK_WIN = 4
+};
+
+static int getKPKIndex(bool white_to_move, Square white_king, Square pawn, Square black_king) {
+    return white_king | (black_king << 6) | (white_to_move << 12) | (getFile(pawn) << 13) | ((RANK_7 - getRank(pawn)) << 15);
+}
+
+/* @brief Classify a position whose result is known without looking at its
+ *  successors, which is the case if it is illegal, if the pawn promotes
+ *  safely or if the pawn is lost or black is stalemated. */
+static KPKResult getInitialKPKResult(bool white_to_move, Square white_king, Square pawn, Square black_king) {
+    Bitboard pawn_attacks = attacks::getPawnAttacks(pawn, WHITE);
+    Bitboard white_king_attacks = getKingAttacks(white_king);
+    Bitboard black_king_attacks = getKingAttacks(black_king);
+    Square promotion_push = pawn + NORTH;
+
+    if (getDistance(white_king, black_king) <= 1 || white_king == pawn || black_king == pawn
+        || (white_to_move && bb::get(pawn_attacks, black_king))) {
+        return KPK_INVALID;
+    }
+    if (white_to_move && getRank(pawn) == RANK_7 && white_king != promotion_push && black_king != promotion_push
+        && (getDistance(black_king, promotion_push) > 1 || getDistance(white_king, promotion_push) == 1)) {
+        return KPK_WIN;
+    }
+    if (!white_to_move && (!(black_king_attacks & ~(white_king_attacks | pawn_attacks))
+                           || bb::get(black_king_attacks & ~white_king_attacks, pawn))) {
+        return KPK_DRAW;
+    }
+    return KPK_UNKNOWN;
+}
+
+/* @brief Classify a position from the results of its successors. White wins
+ *  if one move wins, black draws if one move draws.
+ * @return The result, which is still unknown if no successor decides it. */
+static KPKResult classifyKPK(const std::vector<uint8_t>& results, bool white_to_move,
+                             Square white_king, Square pawn, Square black_king) {
+    KPKResult good = white_to_move ? KPK_WIN : KPK_DRAW;
+    KPKResult bad = white_to_move ? KPK_DRAW : KPK_WIN;
+    int successors = KPK_INVALID;
+    Bitboard king_moves = getKingAttacks(white_to_move ? white_king : black_king);
+    while (king_moves) {
+        Square to = bb::popLSB(king_moves);
+        successors |= white_to_move ? results[getKPKIndex(false, to, pawn, black_king)]
+                                    : results[getKPKIndex(true, white_king, pawn, to)];
+    }
+    if (white_to_move && getRank(pawn) < RANK_7) {
+        Square single_push = pawn + NORTH;
+        successors |= results[getKPKIndex(false, white_king, single_push, black_king)];
+        if (getRank(pawn) == RANK_2 && single_push != white_king && single_push != black_king) {
+            successors |= results[getKPKIndex(false, white_king, single_push + NORTH, black_king)];
+        }
+    }
+    return (successors & good) ? good : (successors & KPK_UNKNOWN) ? KPK_UNKNOWN : bad;
+}
+
+static std::vector<bool> computeKPK() {
+    std::vector<uint8_t> results(KPK_SIZE);
+    auto decode = [] (int index, bool& white_to_move, Square& white_king, Square& pawn, Square& black_king) {
+        white_king = Square(index & 0x3F);
+        black_king = Square((index >> 6) & 0x3F);
+        white_to_move = (index >> 12) & 1;
+        pawn = get_square(RANK_7 - ((index >> 15) & 0x7), (index >> 13) & 0x3);
+    };
+    bool white_to_move;
+    Square white_king, pawn, black_king;
+    for (int index = 0; index < KPK_SIZE; index++) {
+        decode(index, white_to_move, white_king, pawn, black_king);
+        results[index] = getInitialKPKResult(white_to_move, white_king, pawn, black_king);
+    }
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int index = 0; index < KPK_SIZE; index++) {
+            if (results[index] == KPK_UNKNOWN) {
+                decode(index, white_to_move, white_king, pawn, black_king);
+                results[index] = classifyKPK(results, white_to_move, white_king, pawn, black_king);
+                changed |= results[index] != KPK_UNKNOWN;
+            }
+        }
+    }
+    std::vector<bool> bitbase(KPK_SIZE);
+    for (int index = 0; index < KPK_SIZE; index++) {
+        bitbase[index] = results[index] == KPK_WIN;
+    }
+    return bitbase;
+}
+
+bool probeKPK(Square strong_king, Square pawn, Square weak_king, bool strong_to_move) {
+    static const std::vector<bool> BITBASE = computeKPK();
+    assert(getFile(pawn) <= FILE_D && getRank(pawn) >= RANK_2 && getRank(pawn) <= RANK_7);
+    return BITBASE[getKPKIndex(strong_to_move, strong_king, pawn, weak_king)];
+}
+
+Value evaluateDraw(const Board&, Color) {
+    return 0;
+}
+
+Value evaluateKXK(const Board& board, Color strong) {
+    Color weak = !strong;
+    if (isStalemate(board, weak)) {
+        return 0;
+    }
+
+    // the weak king is driven to the edge, where the strong king helps to mate it
+    Square strong_king = board.getKingSquare(strong);
+    Square weak_king = board.getKingSquare(weak);
+    Value score = getNonPawnMaterial(board, strong) + PIECE_VALUES[PAWN] * bb::count(board.getPieceOccupancy(PAWN, strong))
+                + pushToEdge(weak_king) + pushClose(getDistance(strong_king, weak_king));
+
+    // a mate can be forced with a major piece, with bishop and knight or
+    // with bishops of both colors
+    Bitboard bishops = board.getPieceOccupancy(BISHOP, strong);
+    if (board.getPieceOccupancy(QUEEN, strong) || board.getPieceOccupancy(ROOK, strong)
+        || (board.getPieceOccupancy(KNIGHT, strong) && bishops)
+        || ((bishops & DARK_SQUARES_BB) && (bishops & ~DARK_SQUARES_BB))) {
+        score += VALUE_KNOWN_WIN;
+    }
+    return score;
+}
+
+Value evaluateKBNK(const Board& board, Color strong) {
+    Color weak = !strong;
+    if (isStalemate(board, weak)) {
+        return 0;
+    }
+
+    // the mate is only possible in a corner of the color of the bishop, the
+    // dark corners are a1 and h8, for a light bishop the board is mirrored
+    Square strong_king = board.getKingSquare(strong);
+    Square weak_king = board.getKingSquare(weak);
+    bool is_dark = board.getPieceOccupancy(BISHOP, strong) & DARK_SQUARES_BB;
+    Square corner_square = is_dark ? weak_king : Square(weak_king ^ 7);
+    return VALUE_KNOWN_WIN + PIECE_VALUES[BISHOP] + PIECE_VALUES[KNIGHT]
+         + pushClose(getDistance(strong_king, weak_king)) + 420 * pushToCorner(corner_square);
+}
+
+Value evaluateKPK(const Board& board, Color strong) {
+    // look up the position with the pawn moving north on the files a to d
+    Square pawn = bb::getLSB(board.getPieceOccupancy(PAWN, strong));
+    int flip = (strong == WHITE ? 0 : 56) ^ (getFile(pawn) >= FILE_E ? 7 : 0);
+    pawn ^= flip;
+    Square strong_king = board.getKingSquare(strong) ^ flip;
+    Square weak_king = board.getKingSquare(!strong) ^ flip;
+    if (!probeKPK(strong_king, pawn, weak_king, board.getSideToMove() == strong)) {
+        return 0;
+    }
+    return VALUE_KNOWN_WIN + PIECE_VALUES[PAWN] + 10 * getRank(pawn);
+}
+
+Value evaluateKRKB(const Board& board, Color strong) {
+    // drawish, but the rook can make the defence harder near the edge
+    return pushToEdge(board.getKingSquare(!strong));
+}
+
+Value evaluateKRKN(const Board& board, Color strong) {
+    // drawish, unless the knight is cut off from its king at the edge
+    Square weak_king = board.getKingSquare(!strong);
+    Square knight = bb::getLSB(board.getPieceOccupancy(KNIGHT, !strong));
+    return pushToEdge(weak_king) + pushAway(getDistance(weak_king, knight));
+}
+
+Value evaluateKQKR(const Board& board, Color strong) {
+    // won in general, but it takes the kings to come close at the edge
+    Square strong_king = board.getKingSquare(strong);
+    Square weak_king = board.getKingSquare(!strong);
+    return PIECE_VALUES[QUEEN] - PIECE_VALUES[ROOK] + pushToEdge(weak_king) + pushClose(getDistance(strong_king, weak_king));
+}
+
+/* @brief Find the promotion square of pawns that all stand on a rook file.
+ * @return The promotion square, or N_SQUARES if there are pawns on other files. */
+static Square getRookPawnsPromotionSquare(Bitboard pawns, Color color) {
+    int rank = (color == WHITE) ? RANK_8 : RANK_1;
+    if (!(pawns & ~FILE_A_BB)) {
+        return get_square(rank, FILE_A);
+    }
+    if (!(pawns & ~FILE_H_BB)) {
+        return get_square(rank, FILE_H);
+    }
+    return N_SQUARES;
+}
+
+int scaleKBPsK(const Board& board, Color strong) {
+    // rook pawns with a bishop that does not control their promotion square
+    // cannot win against a king in front of them
+    Square promotion = getRookPawnsPromotionSquare(board.getPieceOccupancy(PAWN, strong), strong);
+    if (promotion == N_SQUARES) {
+        return SCALE_NONE;
+    }
+    bool is_dark_bishop = board.getPieceOccupancy(BISHOP, strong) & DARK_SQUARES_BB;
+    bool is_dark_promotion = bb::get(DARK_SQUARES_BB, promotion);
+    if (is_dark_bishop != is_dark_promotion && getDistance(board.getKingSquare(!strong), promotion) <= 1) {
+        return SCALE_DRAW;
+    }
+    return SCALE_NONE;
+}
+
+int scaleKPsK(const Board& board, Color strong) {
+    // rook pawns alone cannot win against a king in front of them
+    Square promotion = getRookPawnsPromotionSquare(board.getPieceOccupancy(PAWN, strong), strong);
+    if (promotion != N_SQUARES && getDistance(board.getKingSquare(!strong), promotion) <= 1) {
+        return SCALE_DRAW;
+    }
+    return SCALE_NONE;
+}
+
+int scaleOppositeBishops(const Board& board, Color strong) {
+    bool is_dark_strong = board.getPieceOccupancy(BISHOP, strong) & DARK_SQUARES_BB;
+    bool is_dark_weak = board.getPieceOccupancy(BISHOP, !strong) & DARK_SQUARES_BB;
+    if (is_dark_strong == is_dark_weak) {
+        return SCALE_NONE;
+    }
+
+    // bishops of opposite colors are hard to win with even with an extra
+    // pawn or two, since the defending bishop blockades the pawns
+    int extra_pawns = bb::count(board.getPieceOccupancy(PAWN, strong)) - bb::count(board.getPieceOccupancy(PAWN, !strong));
+    return std::min(SCALE_NORMAL, 16 + 8 * std::max(extra_pawns, 0));
+}
+
+}   // namespace endgame
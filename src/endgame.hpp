@@ -0,0 +1,75 @@
+#ifndef ENDGAME_HPP
+#define ENDGAME_HPP
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "attacks.hpp"
+#include "bitboard.hpp"
+#include "board.hpp"
+#include "movegen.hpp"
+#include "types.hpp"
+
+namespace endgame {
+
+// score of a position that is won without doubt, far from the mate scores
+const Value VALUE_KNOWN_WIN = 10000;
+
+// factors by which the endgame score of the stronger side is scaled, where
+// SCALE_NONE marks a scaling function that does not apply to the position
+const int SCALE_DRAW = 0;
+const int SCALE_NORMAL = 64;
+const int SCALE_NONE = -1;
+
+/* Evaluation of a specific endgame, from the point of view of the stronger
+   side, which replaces the generic evaluation. */
+using EvaluationFunction = Value (*)(const Board& board, Color strong);
+
+/* Factor by which the endgame score of the stronger side is scaled, which
+   corrects the generic evaluation of drawish endgames. */
+using ScaleFunction = int (*)(const Board& board, Color strong);
+
+/* @brief Compute the material key of an endgame given by its pieces, such
+ *  as "KBNK" for king, bishop and knight against king.
+ * @param code The pieces of the stronger side, starting with its king,
+ *  followed by the pieces of the weaker side, starting with its king.
+ * @param strong The color of the stronger side.
+ * @return The material key of all positions of the endgame. */
+Key getMaterialKey(const std::string& code, Color strong);
+
+/* @brief Look up the specialised evaluation of the endgame with the given
+ *  material key.
+ * @param material_key The material key of the position.
+ * @param strong Set to the color of the stronger side if found.
+ * @return The evaluation function, or none. */
+EvaluationFunction findEvaluation(Key material_key, Color& strong);
+
+/* @brief Test whether a position of king and pawn against king is won,
+ *  using a bitbase computed on first use.
+ * @param strong_king The king of the side with the pawn.
+ * @param pawn The pawn.
+ * @param weak_king The king of the other side.
+ * @param strong_to_move Whether the side with the pawn is to move.
+ * @return A boolean indicating whether the side with the pawn wins. */
+bool probeKPK(Square strong_king, Square pawn, Square weak_king, bool strong_to_move);
+
+// evaluations of endgames, the generic one for a mating advantage against
+// a bare king is chosen by the material, the others by their material key
+Value evaluateDraw(const Board& board, Color strong);
+Value evaluateKXK(const Board& board, Color strong);
+Value evaluateKBNK(const Board& board, Color strong);
+Value evaluateKPK(const Board& board, Color strong);
+Value evaluateKRKB(const Board& board, Color strong);
+Value evaluateKRKN(const Board& board, Color strong);
+Value evaluateKQKR(const Board& board, Color strong);
+
+// scaling functions, which are all chosen by the material
+int scaleKBPsK(const Board& board, Color strong);
+int scaleKPsK(const Board& board, Color strong);
+int scaleOppositeBishops(const Board& board, Color strong);
+
+}   // namespace endgame
+
+#endif
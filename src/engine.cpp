@@ -1,6 +1,6 @@
 #include "engine.hpp"
 
-Engine::Engine() : m_uci(), m_board(), m_running(true) {}
+Engine::Engine() : m_uci(), m_board(), m_table(tt::DEFAULT_SIZE_MB), m_searcher(&m_table), m_running(true) {}
 
 void Engine::start() {
     m_uci.start();
@@ -9,10 +9,11 @@ void Engine::start() {
 
 void Engine::stop() {
     m_running = false;
-    m_uci.stop();
     if (m_engine_thread.joinable()) {
         m_engine_thread.join();
     }
+    stopSearch();
+    m_uci.stop();
 }
 
 void Engine::operate() {
@@ -20,58 +21,279 @@ void Engine::operate() {
         if (m_uci.hasCommand() == true) {
             Command command = m_uci.popCommand();
             processCommand(command);
-            std::cout << "Processed command: " << command.raw() << std::endl;
+            if (m_debug) {
+                m_uci.send("info string processed command: " + command.raw());
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     }
 }
 
 void Engine::reset() {
     m_board = Board();
-    if (!m_is_initialized) {
-        std::cout << "Initializing engine, please wait..." << std::endl;
-        // TODO: initialize all precalculated data structures
-        attacks::precalculate(true);
-        m_is_initialized = true;
+}
+
+void Engine::setPosition(const std::string& fen, const std::vector<std::string>& moves) {
+    m_board = Board(fen);
+    for (const std::string& move : moves) {
+        // the history only has to reach back to the last irreversible move,
+        // and the search needs room for up to MAX_PLY further moves
+        m_board.discardHistory();
+        if (m_board.getPly() + MAX_PLY >= GAME_STATE_HISTORY_LENGTH) {
+            throw InvalidMoveException("Too many moves since the last capture or pawn move: " + move);
+        }
+        m_board.makeMove(parseMove(move));
     }
 }
 
-void Engine::setPosition(const std::string& fen, std::vector<Move> moves) {
-    // TODO: set up the board and play the given move sequence,
-    //       throw an error if the move sequence is invalid
+Move Engine::parseMove(const std::string& move) const {
+    for (const Move& legal_move : MoveList(m_board)) {
+        if (legal_move.toString() == move) {
+            return legal_move;
+        }
+    }
+    throw InvalidMoveException("Invalid move: " + move);
+}
+
+search::Limits Engine::parseLimits(const std::vector<std::string>& args) const {
+    const std::vector<std::string> numeric_limits = {"wtime", "btime", "winc", "binc", "movestogo", "depth", "nodes", "movetime"};
+    search::Limits limits;
+    for (size_t i = 0; i < args.size(); ++i) {
+        // only known limits are parsed, all other tokens such as ponder or
+        // the moves following searchmoves are not supported and skipped
+        const std::string& name = args[i];
+        if (name == "infinite") {
+            limits.infinite = true;
+            continue;
+        }
+        if (std::find(numeric_limits.begin(), numeric_limits.end(), name) == numeric_limits.end()
+            || i + 1 >= args.size()) {
+            continue;
+        }
+        int64_t value;
+        try {
+            value = std::stoll(args[i + 1]);
+        } catch (const std::exception&) {
+            continue;
+        }
+        ++i;
+        if (name == "wtime") {
+            limits.time[WHITE] = value;
+        } else if (name == "btime") {
+            limits.time[BLACK] = value;
+        } else if (name == "winc") {
+            limits.increment[WHITE] = value;
+        } else if (name == "binc") {
+            limits.increment[BLACK] = value;
+        } else if (name == "movestogo") {
+            limits.moves_to_go = value;
+        } else if (name == "depth") {
+            limits.depth = value;
+        } else if (name == "nodes") {
+            limits.nodes = value;
+        } else if (name == "movetime") {
+            limits.move_time = value;
+        }
+    }
+    return limits;
+}
+
+void Engine::setOption(const std::vector<std::string>& args) {
+    // setoption name <name> [value <value>], where the name may contain spaces
+    auto value_begin = std::find(args.begin(), args.end(), "value");
+    std::string name;
+    for (auto it = args.begin() + (args.empty() ? 0 : 1); it != value_begin; ++it) {
+        name += (name.empty() ? "" : " ") + *it;
+    }
+    std::string value;
+    for (auto it = value_begin + (value_begin == args.end() ? 0 : 1); it < args.end(); ++it) {
+        value += (value.empty() ? "" : " ") + *it;
+    }
+
+    stopSearch();
+    if (name == "Hash" && !value.empty()) {
+        size_t size_mb;
+        try {
+            size_mb = std::clamp<long long>(std::stoll(value), 1, tt::MAX_SIZE_MB);
+        } catch (const std::exception&) {
+            m_uci.send("info string invalid value for Hash: " + value);
+            return;
+        }
+        try {
+            m_table.resize(size_mb, m_searcher.getThreads());
+        } catch (const std::bad_alloc&) {
+            m_uci.send("info string could not allocate " + std::to_string(size_mb) + " MB, keeping the previous table");
+        }
+    } else if (name == "Clear Hash") {
+        m_table.clear(m_searcher.getThreads());
+    } else if (name == "Threads" && !value.empty()) {
+        try {
+            m_searcher.setThreads(std::clamp<long long>(std::stoll(value), 1, search::MAX_THREADS));
+        } catch (const std::exception&) {
+            m_uci.send("info string invalid value for Threads: " + value);
+        }
+    } else if (name == "EvalFile") {
+        // an empty path restores the classical evaluation
+        if (value.empty() || value == "<empty>") {
+            nnue::unload();
+            return;
+        }
+        try {
+            nnue::load(value);
+            m_uci.send("info string loaded network " + value);
+        } catch (const InvalidNetworkException& e) {
+            m_uci.send("info string " + std::string(e.what()));
+        }
+    } else if (bool* option = getSearchOption(name); option && !value.empty()) {
+        *option = (value == "true");
+        m_searcher.setOptions(m_search_options);
+    } else {
+        m_uci.send("info string unknown option: " + name);
+    }
+}
+
+bool* Engine::getSearchOption(const std::string& name) {
+    search::Options& options = m_search_options;
+    bool* switches[] = {&options.null_move_pruning, &options.late_move_reductions,
+                        &options.reverse_futility_pruning, &options.futility_pruning,
+                        &options.late_move_pruning};
+    for (size_t i = 0; i < std::size(SEARCH_OPTION_NAMES); i++) {
+        if (name == SEARCH_OPTION_NAMES[i]) {
+            return switches[i];
+        }
+    }
+    return nullptr;
+}
+
+void Engine::startSearch(const search::Limits& limits) {
+    stopSearch();
+    m_table.newSearch();
+    m_search_board = m_board;
+    m_searching = true;
+    m_search_thread = std::thread([this, limits] {
+        search::Report report = m_searcher.search(m_search_board, limits,
+            [this] (const search::Report& iteration) { sendInfo(iteration); });
+        m_uci.send("bestmove " + (report.pv.empty() ? std::string("0000") : report.pv[0].toString()));
+        m_searching = false;
+    });
+}
+
+void Engine::stopSearch() {
+    // the stop signal is repeated, since a search that has only just been
+    // started would reset it
+    while (m_searching) {
+        m_searcher.stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (m_search_thread.joinable()) {
+        m_search_thread.join();
+    }
+}
+
+void Engine::sendInfo(const search::Report& report) {
+    std::string score = search::isMateScore(report.score)
+                      ? "mate " + std::to_string(search::getMateDistance(report.score))
+                      : "cp " + std::to_string(report.score);
+    uint64_t nps = (report.seconds > 0.0) ? uint64_t(report.nodes / report.seconds) : 0;
+    std::string info = "info depth " + std::to_string(report.depth)
+                     + " score " + score
+                     + " nodes " + std::to_string(report.nodes)
+                     + " nps " + std::to_string(nps)
+                     + " time " + std::to_string(int64_t(report.seconds * 1000))
+                     + " hashfull " + std::to_string(m_table.getHashfull())
+                     + " pv";
+    for (const Move& move : report.pv) {
+        info += " " + move.toString();
+    }
+    m_uci.send(info);
+
+    // UCI has no fields for the quiescence nodes and the pawn hash hits, they
+    // are sent as a string to not confuse interfaces parsing the info line
+    auto percentage = [] (uint64_t part, uint64_t total) {
+        uint64_t permille = total ? part * 1000 / total : 0;
+        return std::to_string(permille / 10) + "." + std::to_string(permille % 10) + "%";
+    };
+    m_uci.send("info string qnodes " + std::to_string(report.qnodes)
+               + " (" + percentage(report.qnodes, report.nodes) + " of nodes)"
+               + " pawnhash " + percentage(report.pawn_hits, report.pawn_probes) + " hits");
 }
 
 void Engine::processCommand(Command command) {
     switch(command.type()) {
         case UCI_INIT: {  // initial command
-            std::cout << "id name Schwachmatt" << std::endl;
-            std::cout << "id author Marios Spanakakis" << std::endl;
-            std::cout << "uciok" << std::endl;
+            m_uci.send("id name Schwachmatt");
+            m_uci.send("id author Marios Spanakakis");
+            m_uci.send("option name Hash type spin default " + std::to_string(tt::DEFAULT_SIZE_MB)
+                       + " min 1 max " + std::to_string(tt::MAX_SIZE_MB));
+            m_uci.send("option name Clear Hash type button");
+            m_uci.send("option name Threads type spin default 1 min 1 max " + std::to_string(search::MAX_THREADS));
+            m_uci.send("option name EvalFile type string default <empty>");
+            for (const char* name : SEARCH_OPTION_NAMES) {
+                m_uci.send("option name " + std::string(name) + " type check default "
+                           + (*getSearchOption(name) ? "true" : "false"));
+            }
+            m_uci.send("uciok");
             break;
         }
         case UCI_NEWGAME: {  // start new game
+            stopSearch();
             reset();
+            m_table.clear(m_searcher.getThreads());
+            m_searcher.clear();
             break;
         }
         case UCI_ISREADY: {  // respond when ready
-            // TODO: start a thread that waits for the engine to be ready
-            //       and then send the "readyok" message
+            // commands are processed in order and the search runs in its own
+            // thread, so the engine is always ready to receive the next one
+            m_uci.send("readyok");
             break;
         }
         case UCI_POSITION: {  // set up position
-            // TODO: set up a position according to the given FEN and play the
-            //       given moves
+            // position [startpos | fen <fen>] [moves <move> ...]
+            std::vector<std::string> args = command.args();
+            auto moves_begin = std::find(args.begin(), args.end(), "moves");
+            std::string fen = INITIAL_FEN;
+            if (!args.empty() && args[0] == "fen") {
+                fen.clear();
+                for (auto it = args.begin() + 1; it != moves_begin; ++it) {
+                    fen += (fen.empty() ? "" : " ") + *it;
+                }
+            }
+            std::vector<std::string> moves(moves_begin == args.end() ? args.end() : moves_begin + 1, args.end());
+            stopSearch();
+            try {
+                setPosition(fen, moves);
+            } catch (const std::exception& e) {
+                m_uci.send("info string " + std::string(e.what()));
+                reset();
+            }
             break;
         }
         case UCI_GO: {  // start searching
+            startSearch(parseLimits(command.args()));
             break;
         }
         case UCI_STOP: {  // stop searching
+            stopSearch();
             break;
         }
         case UCI_QUIT: {  // quit operation
+            stopSearch();
+            m_running = false;
             break;
         }
         case UCI_DEBUG: {  // switch debug mode
+            std::vector<std::string> args = command.args();
+            m_debug = !args.empty() && args[0] == "on";
+            m_uci.setDebug(m_debug);
+            break;
+        }
+        case UCI_SETOPTION: {  // set engine option
+            setOption(command.args());
+            break;
+        }
+        default: {
             break;
         }
     }
@@ -5,8 +5,22 @@
 #include "attacks.hpp"
 #include "board.hpp"
 #include "move.hpp"
+#include "movegen.hpp"
+#include "nnue.hpp"
+#include "search.hpp"
+#include "transposition.hpp"
 #include "uci.hpp"
 
+// UCI names of the switches of the selective search, in the order of the
+// members of search::Options
+constexpr const char* SEARCH_OPTION_NAMES[] = {
+    "Null Move Pruning",
+    "Late Move Reductions",
+    "Reverse Futility Pruning",
+    "Futility Pruning",
+    "Late Move Pruning",
+};
+
 class Engine {
 public:
     Engine();
@@ -15,17 +29,59 @@ public:
     void stop();
     void operate();
     void reset();
+    bool isRunning() const { return m_running; }
 private:
     std::thread m_engine_thread;
+    std::thread m_search_thread;
     
     UniversalChessInterface m_uci;
     Board m_board;
+    Board m_search_board;
+    tt::TranspositionTable m_table;
+    search::Searcher m_searcher;
+    search::Options m_search_options;
 
     std::atomic<bool> m_running = true;
-
-    bool m_is_initialized = false;
+    std::atomic<bool> m_searching = false;
+    bool m_debug = false;
 
     void processCommand(Command command);
 
-    void setPosition(const std::string& fen, std::vector<Move> moves);
+    /* @brief Set up a position and play a sequence of moves on it.
+     * @param fen The FEN of the position.
+     * @param moves The moves in UCI notation. */
+    void setPosition(const std::string& fen, const std::vector<std::string>& moves);
+
+    /* @brief Find the legal move of the current position matching the given
+     *  UCI notation, throws an InvalidMoveException if there is none.
+     * @param move The move in UCI notation, e.g. "e7e8q".
+     * @return The move. */
+    Move parseMove(const std::string& move) const;
+
+    /* @brief Parse the limits of the UCI go command.
+     * @param args The arguments of the command.
+     * @return The search limits. */
+    search::Limits parseLimits(const std::vector<std::string>& args) const;
+
+    /* @brief Set an option of the engine as given by the UCI setoption
+     *  command, options without value are buttons.
+     * @param args The arguments of the command. */
+    void setOption(const std::vector<std::string>& args);
+
+    /* @brief Get the switch of a selective search technique.
+     * @param name The UCI name of the option.
+     * @return A pointer to the switch, or nullptr if there is no such option. */
+    bool* getSearchOption(const std::string& name);
+
+    /* @brief Start searching the current position in the search thread, which
+     *  reports its progress and sends the best move when it is done.
+     * @param limits The limits of the search. */
+    void startSearch(const search::Limits& limits);
+
+    /* @brief Stop a running search and wait for its best move to be sent. */
+    void stopSearch();
+
+    /* @brief Send a search report as UCI info string.
+     * @param report The report of a completed iteration. */
+    void sendInfo(const search::Report& report);
 };
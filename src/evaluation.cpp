@@ -0,0 +1,43 @@
+#include "evaluation.hpp"
+
+namespace eval {
+
+/* @brief Evaluate a position that has no specialised evaluation, from the
+ *  score kept by the board, the material and pawn structure entries and the
+ *  attacks of the pieces.
+ * @param board The board to evaluate.
+ * @param material The material entry of the board.
+ * @param pawns The pawn structure entry of the board.
+ * @return The score from the perspective of the side to move. */
+static Value evaluateGeneric(const Board& board, const material::Entry& material, pawns::Entry& pawns) {
+    psqt::Score score = board.getAccumulator().score + material.imbalance + pawns.score;
+    score += mobility::evaluate(board, pawns);
+    score.mg += pawns.getShelter(board, WHITE) - pawns.getShelter(board, BLACK);
+    Color strong = (score.eg >= 0) ? WHITE : BLACK;
+    return taper(board, score, material.phase, material.getScale(board, strong));
+}
+
+Value evaluate(const Board& board, pawns::PawnTable& pawn_table, material::MaterialTable& material_table) {
+    const material::Entry& material = material_table.probe(board);
+    if (material.hasEvaluation()) {
+        return material.evaluate(board);
+    }
+    if (nnue::isLoaded()) {
+        return nnue::evaluate(board);
+    }
+    return evaluateGeneric(board, material, pawn_table.probe(board));
+}
+
+Value evaluate(const Board& board) {
+    material::Entry material = material::evaluate(board);
+    if (material.hasEvaluation()) {
+        return material.evaluate(board);
+    }
+    if (nnue::isLoaded()) {
+        return nnue::propagate(nnue::computeAccumulator(board), board.getSideToMove());
+    }
+    pawns::Entry pawns = pawns::evaluate(board);
+    return evaluateGeneric(board, material, pawns);
+}
+
+}   // namespace eval
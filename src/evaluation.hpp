@@ -0,0 +1,52 @@
+#ifndef EVALUATION_HPP
+#define EVALUATION_HPP
+
+#include <algorithm>
+#include "board.hpp"
+#include "endgame.hpp"
+#include "material.hpp"
+#include "mobility.hpp"
+#include "nnue.hpp"
+#include "pawns.hpp"
+#include "psqt.hpp"
+#include "types.hpp"
+
+namespace eval {
+
+/* @brief Evaluate a position statically, without searching any moves.
+ *  Endgames with a specialised evaluation are dispatched to it by their
+ *  material. Otherwise, the score is the material and piece-square sum
+ *  maintained by the board plus the material imbalance, the pawn structure,
+ *  the king shelters and the mobility, king attacks and threats of the
+ *  pieces, tapered from its middlegame to its endgame value by the game
+ *  phase, where the endgame value is scaled down in drawish endgames. A
+ *  loaded network replaces all of this but the specialised endgames.
+ * @param board The board to evaluate.
+ * @param pawn_table The pawn hash table of the evaluating thread.
+ * @param material_table The material hash table of the evaluating thread.
+ * @return The score in centipawns from the perspective of the side to move. */
+Value evaluate(const Board& board, pawns::PawnTable& pawn_table, material::MaterialTable& material_table);
+
+/* @brief Evaluate a position statically like above, but with the material,
+ *  the pawn structure and the first layer of the network evaluated from
+ *  scratch instead of looked up.
+ * @param board The board to evaluate.
+ * @return The score in centipawns from the perspective of the side to move. */
+Value evaluate(const Board& board);
+
+/* @brief Interpolate between the middlegame and the endgame score of a
+ *  position by its game phase.
+ * @param board The board of the position.
+ * @param score The score from white's point of view.
+ * @param phase The game phase, at most MAX_PHASE.
+ * @param scale The factor of the endgame score, out of SCALE_NORMAL.
+ * @return The tapered score from the perspective of the side to move. */
+inline Value taper(const Board& board, const psqt::Score& score, int phase, int scale = endgame::SCALE_NORMAL) {
+    Value eg = score.eg * scale / endgame::SCALE_NORMAL;
+    Value value = (score.mg * phase + eg * (psqt::MAX_PHASE - phase)) / psqt::MAX_PHASE;
+    return (board.getSideToMove() == WHITE) ? value : -value;
+}
+
+}   // namespace eval
+
+#endif
@@ -9,6 +9,18 @@ public:
         : std::runtime_error(message) {}
 };
 
+class InvalidMoveException : public std::runtime_error {
+public:
+    InvalidMoveException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+class InvalidNetworkException : public std::runtime_error {
+public:
+    InvalidNetworkException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
 class MagicNotFoundException : public std::runtime_error {
 public:
     MagicNotFoundException(const std::string& message)
@@ -7,6 +7,21 @@ void shutdown(int signum) {
 }
 
 int main(int argc, char* argv[]) {
+#ifdef USE_PEXT
+    /* Refuse to run a PEXT build on a CPU that does not support BMI2. */
+    if (!__builtin_cpu_supports("bmi2")) {
+        std::cerr << "This build requires a CPU with BMI2 support, rebuild with USE_PEXT=OFF." << std::endl;
+        return 1;
+    }
+#endif
+#ifdef USE_AVX2
+    /* Refuse to run an AVX2 build on a CPU that does not support it. */
+    if (!__builtin_cpu_supports("avx2")) {
+        std::cerr << "This build requires a CPU with AVX2 support, rebuild with USE_AVX2=OFF." << std::endl;
+        return 1;
+    }
+#endif
+
     /* Connect shutdown signal to signal handler. */
     std::signal(SIGINT, shutdown);
 
@@ -14,8 +29,9 @@ int main(int argc, char* argv[]) {
     Engine engine;
     engine.start();
 
-    /* Keep the program running while all operation happens in threads. */
-    while (running) {
+    /* Keep the program running while all operation happens in threads, until
+       interrupted or until the GUI quits. */
+    while (running && engine.isRunning()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
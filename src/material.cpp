@@ -0,0 +1,86 @@
+#include "material.hpp"
+
+namespace material {
+
+Entry evaluate(const Board& board) {
+    Entry entry;
+    entry.key = board.getMaterialKey();
+
+    int counts[N_COLORS][N_PIECE_TYPES] = {};
+    Value non_pawn_material[N_COLORS] = {0, 0};
+    for (Color color : {WHITE, BLACK}) {
+        for (PieceType pieceType = PAWN; pieceType <= QUEEN; pieceType++) {
+            counts[color][pieceType] = bb::count(board.getPieceOccupancy(pieceType, color));
+            entry.phase += psqt::PHASE_WEIGHTS[pieceType] * counts[color][pieceType];
+            non_pawn_material[color] += (pieceType != PAWN) ? PIECE_VALUES[pieceType] * counts[color][pieceType] : 0;
+        }
+    }
+    // a position with promoted pieces counts as a pure middlegame
+    entry.phase = std::min(entry.phase, psqt::MAX_PHASE);
+
+    // without pawns, a single minor piece cannot mate
+    if (!counts[WHITE][PAWN] && !counts[BLACK][PAWN]
+        && non_pawn_material[WHITE] + non_pawn_material[BLACK] <= PIECE_VALUES[BISHOP]) {
+        entry.is_draw = true;
+        entry.evaluation = endgame::evaluateDraw;
+        return entry;
+    }
+
+    // endgames with a specialised evaluation, either registered for their
+    // exact material or a mating advantage against a bare king
+    entry.evaluation = endgame::findEvaluation(entry.key, entry.strong);
+    if (entry.evaluation) {
+        return entry;
+    }
+    for (Color color : {WHITE, BLACK}) {
+        Color them = !color;
+        if (non_pawn_material[color] >= PIECE_VALUES[ROOK] && !non_pawn_material[them] && !counts[them][PAWN]) {
+            entry.evaluation = endgame::evaluateKXK;
+            entry.strong = color;
+            return entry;
+        }
+    }
+
+    for (Color color : {WHITE, BLACK}) {
+        Color them = !color;
+        psqt::Score imbalance;
+        if (counts[color][BISHOP] >= 2) {
+            imbalance += BISHOP_PAIR;
+        }
+        imbalance += KNIGHT_PER_PAWN * (counts[color][KNIGHT] * (counts[color][PAWN] - 5));
+        imbalance += ROOK_PER_PAWN * (counts[color][ROOK] * (counts[color][PAWN] - 5));
+        entry.imbalance += (color == WHITE) ? imbalance : -imbalance;
+
+        // rook pawns may not be able to promote against the enemy king
+        if (counts[color][BISHOP] == 1 && non_pawn_material[color] == PIECE_VALUES[BISHOP] && counts[color][PAWN]) {
+            entry.scales[color] = endgame::scaleKBPsK;
+        } else if (!non_pawn_material[color] && counts[color][PAWN] >= 2 && !non_pawn_material[them] && !counts[them][PAWN]) {
+            entry.scales[color] = endgame::scaleKPsK;
+        }
+
+        // without pawns, a side needs more than a minor piece of advantage
+        if (!counts[color][PAWN] && non_pawn_material[color] - non_pawn_material[them] <= PIECE_VALUES[BISHOP]) {
+            entry.factors[color] = (non_pawn_material[color] < PIECE_VALUES[ROOK]) ? endgame::SCALE_DRAW
+                                 : (non_pawn_material[them] <= PIECE_VALUES[BISHOP]) ? 4 : 14;
+        }
+    }
+
+    // a single bishop on each side, which may be of opposite colors
+    if (non_pawn_material[WHITE] == PIECE_VALUES[BISHOP] && non_pawn_material[BLACK] == PIECE_VALUES[BISHOP]
+        && counts[WHITE][BISHOP] == 1 && counts[BLACK][BISHOP] == 1) {
+        entry.scales[WHITE] = endgame::scaleOppositeBishops;
+        entry.scales[BLACK] = endgame::scaleOppositeBishops;
+    }
+    return entry;
+}
+
+const Entry& MaterialTable::probe(const Board& board) {
+    Key key = board.getMaterialKey();
+    Entry& entry = m_entries[key & (TABLE_SIZE - 1)];
+    if (entry.key != key) {
+        entry = evaluate(board);
+    }
+    return entry;
+}
+
+}   // namespace material
@@ -0,0 +1,85 @@
+#ifndef MATERIAL_HPP
+#define MATERIAL_HPP
+
+#include <memory>
+#include <stdint.h>
+#include "board.hpp"
+#include "endgame.hpp"
+#include "psqt.hpp"
+#include "types.hpp"
+
+namespace material {
+
+const size_t TABLE_SIZE = 1 << 13;      // entries per table, a power of two
+
+// bonus for the pair of bishops, and corrections of the knight and rook
+// values per own pawn more or less than five, knights gain value in closed
+// positions while rooks need open files
+constexpr psqt::Score BISHOP_PAIR = {30, 50};
+constexpr psqt::Score KNIGHT_PER_PAWN = {6, 6};
+constexpr psqt::Score ROOK_PER_PAWN = {-12, -12};
+
+/* Evaluation terms that only depend on the number of pieces of each kind,
+   which is looked up by the material key. An entry either refers to a
+   specialised evaluation of the endgame, which replaces the generic one, or
+   provides the game phase, the material imbalance and the scaling of the
+   endgame score for the generic evaluation. */
+struct Entry {
+    Key key = 0;
+    int phase = 0;                                  // sum of the phase weights, capped at the maximum
+    psqt::Score imbalance;                          // score of white's imbalance minus black's
+    endgame::EvaluationFunction evaluation = nullptr;
+    Color strong = WHITE;                           // stronger side of the specialised evaluation
+    endgame::ScaleFunction scales[N_COLORS] = {};   // scaling of the endgame score of each side
+    int factors[N_COLORS] = {endgame::SCALE_NORMAL, endgame::SCALE_NORMAL};
+    bool is_draw = false;                           // neither side has enough material to mate
+
+    /* @brief Test whether the endgame has a specialised evaluation. */
+    bool hasEvaluation() const { return evaluation != nullptr; }
+
+    /* @brief Evaluate the position with the specialised evaluation.
+     * @param board The board, whose material must match the entry.
+     * @return The score from the perspective of the side to move. */
+    Value evaluate(const Board& board) const {
+        Value score = evaluation(board, strong);
+        return (board.getSideToMove() == strong) ? score : -score;
+    }
+
+    /* @brief Get the factor by which to scale the endgame score of a side,
+     *  where a scaling function takes precedence over the default factor.
+     * @param board The board, whose material must match the entry.
+     * @param color The side with the better endgame score.
+     * @return The factor, out of SCALE_NORMAL. */
+    int getScale(const Board& board, Color color) const {
+        int scale = scales[color] ? scales[color](board, color) : endgame::SCALE_NONE;
+        return (scale != endgame::SCALE_NONE) ? scale : factors[color];
+    }
+};
+
+/* @brief Compute the entry of the material of a position from scratch.
+ * @param board The board to evaluate.
+ * @return The entry, with the material key of the board. */
+Entry evaluate(const Board& board);
+
+/* Hash table of material evaluations, which belongs to a single search
+   thread and therefore needs no synchronisation. The number of distinct
+   material configurations in a search is small, so a new entry always
+   replaces the old one. No position has a zero material key, since both
+   kings are part of it. */
+class MaterialTable {
+    public:
+    MaterialTable() : m_entries(std::make_unique<Entry[]>(TABLE_SIZE)) {}
+
+    /* @brief Get the entry of the material of a board, which is evaluated
+     *  and stored if it is not in the table yet.
+     * @param board The board to look up.
+     * @return The entry, which stays valid until the next probe. */
+    const Entry& probe(const Board& board);
+
+    private:
+    std::unique_ptr<Entry[]> m_entries;
+};
+
+}   // namespace material
+
+#endif
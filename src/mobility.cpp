@@ -0,0 +1,229 @@
+#include "mobility.hpp"
+
+#ifdef USE_AVX2
+#include <immintrin.h>
+#endif
+
+namespace mobility {
+
+/* @brief Append the attacks of all pieces of one type and color to a table.
+ * @tparam TPieceType The type of the pieces.
+ * @param board The board.
+ * @param color The color of the pieces.
+ * @param targets The enemy pieces more valuable than the pieces.
+ * @param table The table to append to. */
+template <PieceType TPieceType>
+static void collectPieces(const Board& board, Color color, Bitboard targets, AttackTable& table) {
+    Bitboard occupancy = board.getTotalOccupancy();
+    Bitboard pieces = board.getPieceOccupancy(TPieceType, color);
+    while (pieces) {
+        Square square = bb::popLSB(pieces);
+        int index = table.n_pieces[color]++;
+        assert(index < MAX_PIECES);
+        table.attacks[color][index] = attacks::getPieceAttacks<TPieceType>(square, occupancy);
+        table.targets[color][index] = targets;
+        table.king_weights[color][index] = KING_ATTACK_WEIGHTS[TPieceType];
+        table.types[color][index] = TPieceType;
+    }
+}
+
+void collect(const Board& board, const pawns::Entry& pawns, AttackTable& table) {
+    for (Color color : {WHITE, BLACK}) {
+        Color them = !color;
+        Square king = board.getKingSquare(color);
+        table.king_zone[color] = attacks::getPieceAttacks<KING>(king, 0ULL) | bb::getBitboard(king);
+        table.mobility_area[color] = ~(board.getPieceOccupancy(PAWN, color) | bb::getBitboard(king) | pawns.attacks[them]);
+
+        Bitboard queens = board.getPieceOccupancy(QUEEN, them);
+        Bitboard rooks = board.getPieceOccupancy(ROOK, them);
+        table.n_pieces[color] = 0;
+        collectPieces<KNIGHT>(board, color, rooks | queens, table);
+        collectPieces<BISHOP>(board, color, rooks | queens, table);
+        collectPieces<ROOK>(board, color, queens, table);
+        collectPieces<QUEEN>(board, color, 0ULL, table);
+
+        // empty the entries up to the next multiple of four
+        for (int index = table.n_pieces[color]; index % 4 != 0; index++) {
+            table.attacks[color][index] = 0ULL;
+            table.targets[color][index] = 0ULL;
+            table.king_weights[color][index] = 0;
+        }
+    }
+}
+
+void countScalar(const AttackTable& table, AttackCounts& counts) {
+    for (Color color : {WHITE, BLACK}) {
+        Bitboard area = table.mobility_area[color];
+        Bitboard king_zone = table.king_zone[!color];
+        counts.king_attack_weights[color] = 0;
+        counts.king_attackers[color] = 0;
+        counts.threats[color] = 0ULL;
+        for (int index = 0; index < table.n_pieces[color]; index++) {
+            Bitboard attacks = table.attacks[color][index];
+            uint64_t king_attacks = bb::count(attacks & king_zone);
+            counts.mobility[color][index] = bb::count(attacks & area);
+            counts.king_attack_weights[color] += king_attacks * table.king_weights[color][index];
+            counts.king_attackers[color] += king_attacks != 0;
+            counts.threats[color] |= attacks & table.targets[color][index];
+        }
+    }
+}
+
+#ifdef USE_AVX2
+/* @brief Count the set bits of four bitboards at once, by looking up the
+ *  counts of all nibbles with a byte shuffle and summing up the bytes of each
+ *  bitboard, since AVX2 has no population count instruction.
+ * @param v Four bitboards.
+ * @return The four counts. */
+static inline __m256i popcount256(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_and_si256(v, low_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+/* @brief Sum up the four 64-bit lanes of a register. */
+static inline uint64_t sum256(__m256i v) {
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return uint64_t(_mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1));
+}
+
+/* @brief Combine the four 64-bit lanes of a register by bitwise or. */
+static inline Bitboard or256(__m256i v) {
+    __m128i any = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return Bitboard(_mm_cvtsi128_si64(any) | _mm_extract_epi64(any, 1));
+}
+
+void count(const AttackTable& table, AttackCounts& counts) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    for (Color color : {WHITE, BLACK}) {
+        __m256i area = _mm256_set1_epi64x(int64_t(table.mobility_area[color]));
+        __m256i king_zone = _mm256_set1_epi64x(int64_t(table.king_zone[!color]));
+        __m256i king_attack_weights = zero;
+        __m256i king_attackers = zero;
+        __m256i threats = zero;
+        for (int index = 0; index < table.n_pieces[color]; index += 4) {
+            __m256i attacks = _mm256_load_si256(reinterpret_cast<const __m256i*>(&table.attacks[color][index]));
+            __m256i targets = _mm256_load_si256(reinterpret_cast<const __m256i*>(&table.targets[color][index]));
+            __m256i weights = _mm256_load_si256(reinterpret_cast<const __m256i*>(&table.king_weights[color][index]));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&counts.mobility[color][index]),
+                               popcount256(_mm256_and_si256(attacks, area)));
+
+            // the counts and weights are small, so multiplying their lower
+            // halves is enough
+            __m256i king_attacks = popcount256(_mm256_and_si256(attacks, king_zone));
+            king_attack_weights = _mm256_add_epi64(king_attack_weights, _mm256_mul_epu32(king_attacks, weights));
+            king_attackers = _mm256_add_epi64(king_attackers, _mm256_andnot_si256(_mm256_cmpeq_epi64(king_attacks, zero), one));
+            threats = _mm256_or_si256(threats, _mm256_and_si256(attacks, targets));
+        }
+        counts.king_attack_weights[color] = sum256(king_attack_weights);
+        counts.king_attackers[color] = int(sum256(king_attackers));
+        counts.threats[color] = or256(threats);
+    }
+}
+#else
+void count(const AttackTable& table, AttackCounts& counts) {
+    countScalar(table, counts);
+}
+#endif
+
+/* Attacks of the pieces of one side on the enemy king and pieces, summed up
+   over the pieces. */
+struct SideAttacks {
+    uint64_t king_attack_weights = 0;
+    int king_attackers = 0;
+    Bitboard threats = 0ULL;
+};
+
+/* @brief Score the mobility of all pieces of one type and color, and add
+ *  their attacks on the enemy king and pieces.
+ * @tparam TPieceType The type of the pieces.
+ * @param board The board.
+ * @param color The color of the pieces.
+ * @param area The mobility area of the pieces.
+ * @param king_zone The zone of the enemy king.
+ * @param targets The enemy pieces more valuable than the pieces.
+ * @param side The attacks to add to.
+ * @return The mobility score of the pieces. */
+template <PieceType TPieceType>
+static psqt::Score evaluatePieces(const Board& board, Color color, Bitboard area, Bitboard king_zone,
+                                  Bitboard targets, SideAttacks& side) {
+    psqt::Score score;
+    Bitboard occupancy = board.getTotalOccupancy();
+    Bitboard pieces = board.getPieceOccupancy(TPieceType, color);
+    while (pieces) {
+        Square square = bb::popLSB(pieces);
+        Bitboard attacks = attacks::getPieceAttacks<TPieceType>(square, occupancy);
+        int king_attacks = bb::count(attacks & king_zone);
+        score += MOBILITY_WEIGHTS[TPieceType] * (bb::count(attacks & area) - MOBILITY_OFFSETS[TPieceType]);
+        side.king_attack_weights += king_attacks * KING_ATTACK_WEIGHTS[TPieceType];
+        side.king_attackers += king_attacks != 0;
+        side.threats |= attacks & targets;
+    }
+    return score;
+}
+
+/* @brief Score the attacks of one side on the enemy king and pieces.
+ * @param board The board.
+ * @param pawns The pawn structure entry of the board.
+ * @param color The attacking side.
+ * @param side The attacks of the pieces of the side.
+ * @return The score of the side. */
+static psqt::Score evaluateAttacks(const Board& board, const pawns::Entry& pawns, Color color, const SideAttacks& side) {
+    Color them = !color;
+    int attackers = std::min(side.king_attackers, 7);
+    psqt::Score score = KING_DANGER * int(side.king_attack_weights * KING_ATTACKER_SHARES[attackers] / 100);
+
+    Bitboard their_pieces = board.getColorOccupancy(them) & ~board.getPieceOccupancy(PAWN, them)
+                          & ~board.getPieceOccupancy(KING, them);
+    score += THREAT * bb::count(side.threats);
+    score += THREAT_BY_PAWN * bb::count(pawns.attacks[color] & their_pieces);
+    return score;
+}
+
+psqt::Score evaluatePerPiece(const Board& board, const pawns::Entry& pawns) {
+    psqt::Score scores[N_COLORS];
+    for (Color color : {WHITE, BLACK}) {
+        Color them = !color;
+        Square king = board.getKingSquare(color);
+        Square their_king = board.getKingSquare(them);
+        Bitboard area = ~(board.getPieceOccupancy(PAWN, color) | bb::getBitboard(king) | pawns.attacks[them]);
+        Bitboard king_zone = attacks::getPieceAttacks<KING>(their_king, 0ULL) | bb::getBitboard(their_king);
+        Bitboard queens = board.getPieceOccupancy(QUEEN, them);
+        Bitboard rooks = board.getPieceOccupancy(ROOK, them);
+
+        SideAttacks side;
+        psqt::Score& score = scores[color];
+        score += evaluatePieces<KNIGHT>(board, color, area, king_zone, rooks | queens, side);
+        score += evaluatePieces<BISHOP>(board, color, area, king_zone, rooks | queens, side);
+        score += evaluatePieces<ROOK>(board, color, area, king_zone, queens, side);
+        score += evaluatePieces<QUEEN>(board, color, area, king_zone, 0ULL, side);
+        score += evaluateAttacks(board, pawns, color, side);
+    }
+    return scores[WHITE] - scores[BLACK];
+}
+
+psqt::Score evaluateCollected(const Board& board, const pawns::Entry& pawns) {
+    AttackTable table;
+    AttackCounts counts;
+    collect(board, pawns, table);
+    count(table, counts);
+
+    psqt::Score scores[N_COLORS];
+    for (Color color : {WHITE, BLACK}) {
+        psqt::Score& score = scores[color];
+        for (int index = 0; index < table.n_pieces[color]; index++) {
+            PieceType pieceType = table.types[color][index];
+            score += MOBILITY_WEIGHTS[pieceType] * (int(counts.mobility[color][index]) - MOBILITY_OFFSETS[pieceType]);
+        }
+        SideAttacks side = {counts.king_attack_weights[color], counts.king_attackers[color], counts.threats[color]};
+        score += evaluateAttacks(board, pawns, color, side);
+    }
+    return scores[WHITE] - scores[BLACK];
+}
+
+}   // namespace mobility
@@ -0,0 +1,104 @@
+#ifndef MOBILITY_HPP
+#define MOBILITY_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <stdint.h>
+#include "attacks.hpp"
+#include "bitboard.hpp"
+#include "board.hpp"
+#include "pawns.hpp"
+#include "psqt.hpp"
+#include "types.hpp"
+
+namespace mobility {
+
+// knights, bishops, rooks and queens per side, a multiple of the four
+// bitboards that fit into one AVX2 register
+const int MAX_PIECES = 16;
+
+// bonus per square of the mobility area that a piece attacks beyond a
+// typical number of squares, and that typical number
+constexpr psqt::Score MOBILITY_WEIGHTS[N_PIECE_TYPES] = {{0, 0}, {0, 0}, {4, 4}, {5, 5}, {2, 4}, {1, 2}, {0, 0}};
+constexpr int MOBILITY_OFFSETS[N_PIECE_TYPES] = {0, 0, 4, 7, 7, 14, 0};
+
+// weight of each attack of a piece on the squares around the enemy king,
+// of which only a share counts unless several pieces attack the king
+constexpr uint64_t KING_ATTACK_WEIGHTS[N_PIECE_TYPES] = {0, 0, 2, 2, 3, 5, 0};
+constexpr int KING_ATTACKER_SHARES[8] = {0, 0, 50, 75, 88, 94, 97, 99};
+constexpr psqt::Score KING_DANGER = {4, 1};
+
+// bonus per enemy piece attacked by a less valuable piece or by a pawn
+constexpr psqt::Score THREAT = {40, 30};
+constexpr psqt::Score THREAT_BY_PAWN = {60, 40};
+
+/* Attacks of the knights, bishops, rooks and queens of both sides, collected
+   into fixed arrays so that they can be counted four at a time. The entries
+   beyond the last piece of a side are empty up to the next multiple of four. */
+struct AttackTable {
+    alignas(32) Bitboard attacks[N_COLORS][MAX_PIECES];         // squares attacked by each piece
+    alignas(32) Bitboard targets[N_COLORS][MAX_PIECES];         // enemy pieces more valuable than each piece
+    alignas(32) uint64_t king_weights[N_COLORS][MAX_PIECES];    // weight of each piece's attacks on the enemy king
+    PieceType types[N_COLORS][MAX_PIECES];
+    int n_pieces[N_COLORS];
+    Bitboard mobility_area[N_COLORS];   // squares not blocked by own pawns or the king, nor attacked by enemy pawns
+    Bitboard king_zone[N_COLORS];       // the king and the squares around it
+};
+
+/* Counts over the attack table. */
+struct AttackCounts {
+    alignas(32) uint64_t mobility[N_COLORS][MAX_PIECES];        // attacked squares of the mobility area by piece
+    uint64_t king_attack_weights[N_COLORS];                     // weighted attacks on the enemy king zone
+    int king_attackers[N_COLORS];                               // pieces attacking the enemy king zone
+    Bitboard threats[N_COLORS];                                 // enemy pieces attacked by less valuable pieces
+};
+
+/* @brief Collect the attacks of all pieces but pawns and kings.
+ * @param board The board.
+ * @param pawns The pawn structure entry of the board, for the pawn attacks.
+ * @param table The table to fill. */
+void collect(const Board& board, const pawns::Entry& pawns, AttackTable& table);
+
+/* @brief Count the attacks of a table, four pieces at a time with AVX2 when
+ *  built with USE_AVX2 and with the scalar fallback otherwise.
+ * @param table The collected attacks.
+ * @param counts The counts to fill. */
+void count(const AttackTable& table, AttackCounts& counts);
+
+/* @brief Count the attacks of a table one piece at a time.
+ * @param table The collected attacks.
+ * @param counts The counts to fill. */
+void countScalar(const AttackTable& table, AttackCounts& counts);
+
+/* @brief Score the mobility, the attacks on the enemy king and the threats
+ *  against enemy pieces of both sides, with a loop over the pieces.
+ * @param board The board.
+ * @param pawns The pawn structure entry of the board.
+ * @return The score of white minus the score of black. */
+psqt::Score evaluatePerPiece(const Board& board, const pawns::Entry& pawns);
+
+/* @brief Score the same as evaluatePerPiece, after collecting the attacks
+ *  into a table and counting them.
+ * @param board The board.
+ * @param pawns The pawn structure entry of the board.
+ * @return The score of white minus the score of black. */
+psqt::Score evaluateCollected(const Board& board, const pawns::Entry& pawns);
+
+/* @brief Score the mobility, the attacks on the enemy king and the threats
+ *  against enemy pieces of both sides, after collecting the attacks when
+ *  built with USE_COLLECTED_MOBILITY and with a loop over the pieces
+ *  otherwise, which is faster on the positions of the Mobility benchmark.
+ * @param board The board.
+ * @param pawns The pawn structure entry of the board.
+ * @return The score of white minus the score of black. */
+inline psqt::Score evaluate(const Board& board, const pawns::Entry& pawns) {
+#ifdef USE_COLLECTED_MOBILITY
+    return evaluateCollected(board, pawns);
+#else
+    return evaluatePerPiece(board, pawns);
+#endif
+}
+
+}   // namespace mobility
+
+#endif
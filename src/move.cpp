@@ -30,5 +30,9 @@ void Move::printDetails() const {
 }
 
 std::string Move::toString() const {
-    return std::string(SQUARE_NAMES[getFrom()]) + std::string(SQUARE_NAMES[getTo()]);
+    std::string move = std::string(SQUARE_NAMES[getFrom()]) + std::string(SQUARE_NAMES[getTo()]);
+    if (isPromotion()) {
+        move += PIECE_SYMBOLS[make_piece(BLACK, getPromotionPieceType())];
+    }
+    return move;
 }
@@ -25,6 +25,7 @@ class Move {
     public:
     Move();
     Move(Square from, Square to, MoveFlag flag);
+    explicit Move(uint16_t raw) : move_(raw) {}
     ~Move() = default;
     inline Square getTo() const { return (move_ >> TO_SHIFT) & 0x3f; };
     inline void setTo(Square to) { move_ |= (to << TO_SHIFT); };
@@ -32,14 +33,19 @@ class Move {
     inline void setFrom(Square from) { move_ |= (from << FROM_SHIFT); };
     inline MoveFlag getFlag() const { return (move_ >> FLAG_SHIFT) & 0b1111; };
     inline void setFlag(MoveFlag flag) { move_ |= (flag << FLAG_SHIFT); };
+    inline uint16_t getRaw() const { return move_; };
 
-    inline bool isCapture() { return (move_ >> FLAG_SHIFT) & 0b0100; };
-    inline bool isDoublePawnPush() { return (move_ >> FLAG_SHIFT) == 0b0001; };
-    inline bool isEnPassantCapture() { return (move_ >> FLAG_SHIFT) == 0b0101; };
-    inline bool isPromotion() { return (move_ >> FLAG_SHIFT) & 0b1000; };
-    inline PieceType getPromotionPieceType() { return PieceType(((move_ >> FLAG_SHIFT) & 0b0011) + 2);};
-    inline bool isCastling() { return (getFlag() == KINGSIDE_CASTLE || getFlag() == QUEENSIDE_CASTLE);};
+    inline bool isCapture() const { return (move_ >> FLAG_SHIFT) & 0b0100; };
+    inline bool isDoublePawnPush() const { return (move_ >> FLAG_SHIFT) == 0b0001; };
+    inline bool isEnPassantCapture() const { return (move_ >> FLAG_SHIFT) == 0b0101; };
+    inline bool isPromotion() const { return (move_ >> FLAG_SHIFT) & 0b1000; };
+    inline PieceType getPromotionPieceType() const { return PieceType(((move_ >> FLAG_SHIFT) & 0b0011) + 2);};
+    inline bool isCastling() const { return (getFlag() == KINGSIDE_CASTLE || getFlag() == QUEENSIDE_CASTLE);};
+
+    bool operator==(const Move& other) const = default;
     
+    /* @brief Get the move in UCI long algebraic notation, e.g. "e7e8q".
+     * @return The move string. */
     std::string toString() const;
     void printDetails() const;
 };
@@ -1,39 +1,117 @@
 #include "movegen.hpp"
 
-template <Color TColor>
+/* Masks restricting the move generation to strictly legal moves. They are
+   computed once per node from the checking and the pinned pieces. For quiet
+   check generation, the squares from which each piece type would give check
+   and the pieces that can give a discovered check are added. */
+struct LegalityMasks {
+    Square king_square;
+    Bitboard checkers;      // enemy pieces giving check
+    Bitboard pinned;        // own pieces pinned to the king
+    Bitboard evasions;      // target squares resolving a single check
+
+    Square their_king_square;
+    Bitboard check_squares[N_PIECE_TYPES];  // squares giving check, by piece type
+    Bitboard discoverers;   // own pieces blocking an attack on the enemy king
+};
+
+template <GenerationType TType, Color TColor>
+static LegalityMasks getLegalityMasks(const Board& board);
+
+template <GenerationType TType, Color TColor>
 static Move* generateAllMoves(const Board& board, Move* movelist);
 
-template <Color TColor>
-static Move* generatePawnMoves(const Board& board, Move* movelist);
+template <GenerationType TType, Color TColor>
+static Move* generatePawnMoves(const Board& board, Move* movelist, const LegalityMasks& masks);
+
+template <GenerationType TType, Color TColor, PieceType TPieceType>
+static Move* generatePieceMoves(const Board& board, Move* movelist, const LegalityMasks& masks);
+
+template <GenerationType TType, Color TColor>
+static Move* generateCastlingMoves(const Board& board, Move* movelist);
 
 template <Color TColor, PieceType TPieceType>
-static Move* generatePieceMoves(const Board& board, Move* movelist);
+static uint64_t countPieceMoves(const Board& board, const LegalityMasks& masks);
 
 template <Color TColor>
-static Move* generateCastlingMoves(const Board& board, Move* movelist);
+static uint64_t countAllMoves(const Board& board);
+
+template <Color TColor>
+static Bitboard getSafeKingTargets(const Board& board, const LegalityMasks& masks, Bitboard targets);
 
 
+template <GenerationType TType>
 Move* generate(const Board& board, Move* movelist) {
     Color us = board.getSideToMove();
-    return (us == WHITE) ? generateAllMoves<WHITE>(board, movelist)
-                         : generateAllMoves<BLACK>(board, movelist);
+    return (us == WHITE) ? generateAllMoves<TType, WHITE>(board, movelist)
+                         : generateAllMoves<TType, BLACK>(board, movelist);
 }
 
-template <Color TColor>
+uint64_t countLegalMoves(const Board& board) {
+    Color us = board.getSideToMove();
+    return (us == WHITE) ? countAllMoves<WHITE>(board)
+                         : countAllMoves<BLACK>(board);
+}
+
+template <GenerationType TType, Color TColor>
+static LegalityMasks getLegalityMasks(const Board& board) {
+    LegalityMasks masks;
+    masks.king_square = board.getKingSquare(TColor);
+
+    // pseudo-legal move generation is not restricted at all
+    if (TType == PSEUDO_LEGAL) {
+        masks.checkers = 0ULL;
+        masks.pinned = 0ULL;
+        masks.evasions = ~0ULL;
+        return masks;
+    }
+
+    masks.checkers = board.getCheckers();
+    masks.pinned = board.getKingBlockers(TColor) & board.getColorOccupancy(TColor);
+
+    // when in check, a move must either capture the checking piece or block
+    // its attack (only relevant for a single checker, see below)
+    if (masks.checkers) {
+        Square checker = bb::getLSB(masks.checkers);
+        masks.evasions = attacks::getSquaresBetween(masks.king_square, checker) | masks.checkers;
+    } else {
+        assert(TType != EVASIONS);  // evasions are only generated when in check
+        masks.evasions = ~0ULL;
+    }
+
+    // a quiet move gives check if the piece attacks the enemy king from its
+    // target square or if it uncovers an attack of one of our sliders
+    if (TType == QUIET_CHECKS) {
+        masks.their_king_square = board.getKingSquare(!TColor);
+        for (PieceType pieceType : {PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING}) {
+            masks.check_squares[pieceType] = board.getCheckSquares(pieceType);
+        }
+        masks.discoverers = board.getKingBlockers(!TColor) & board.getColorOccupancy(TColor);
+    }
+
+    return masks;
+}
+
+template <GenerationType TType, Color TColor>
 static Move* generateAllMoves(const Board& board, Move* movelist) {
-    
-    movelist = generatePawnMoves<TColor>(board, movelist);
-    movelist = generatePieceMoves<TColor, KNIGHT>(board, movelist);
-    movelist = generatePieceMoves<TColor, BISHOP>(board, movelist);
-    movelist = generatePieceMoves<TColor, ROOK>(board, movelist);
-    movelist = generatePieceMoves<TColor, QUEEN>(board, movelist);
-    movelist = generatePieceMoves<TColor, KING>(board, movelist);
+
+    LegalityMasks masks = getLegalityMasks<TType, TColor>(board);
+
+    // in double check, only the king is allowed to move
+    if (bb::count(masks.checkers) < 2) {
+        movelist = generatePawnMoves<TType, TColor>(board, movelist, masks);
+        movelist = generatePieceMoves<TType, TColor, KNIGHT>(board, movelist, masks);
+        movelist = generatePieceMoves<TType, TColor, BISHOP>(board, movelist, masks);
+        movelist = generatePieceMoves<TType, TColor, ROOK>(board, movelist, masks);
+        movelist = generatePieceMoves<TType, TColor, QUEEN>(board, movelist, masks);
+    }
+    movelist = generatePieceMoves<TType, TColor, KING>(board, movelist, masks);
 
     return movelist;
 }
 
-template <Color TColor, PieceType TPieceType>
-static Move* generatePieceMoves(const Board& board, Move* movelist) {
+template <GenerationType TType, Color TColor, PieceType TPieceType>
+static Move* generatePieceMoves(const Board& board, Move* movelist, const LegalityMasks& masks) {
 
     assert(TPieceType != PAWN);  // pawn move generation is handled separately
 
@@ -42,7 +120,12 @@ static Move* generatePieceMoves(const Board& board, Move* movelist) {
     Bitboard their_pieces = board.getColorOccupancy(!TColor);
     Bitboard all_pieces = board.getTotalOccupancy();
     Bitboard pieces = board.getPieceOccupancy(TPieceType, TColor);
-    
+
+    // restrict the target squares to the requested kind of moves
+    Bitboard targets = (TType == CAPTURES) ? their_pieces
+                     : (TType == QUIETS || TType == QUIET_CHECKS) ? ~all_pieces
+                     : ~our_pieces;
+
     // for each piece, get the attacked squares
     while (pieces) {
         // extract one of the pieces
@@ -51,8 +134,30 @@ static Move* generatePieceMoves(const Board& board, Move* movelist) {
         // lookup the squares which are attacked by this piece
         Bitboard attacks = attacks::getPieceAttacks<TPieceType>(from, all_pieces);
 
-        // remove the attacked squares which are occupied by friendly pieces
-        attacks &= ~our_pieces;
+        // remove the attacked squares which are not of the requested kind,
+        // e.g. squares occupied by friendly pieces
+        attacks &= targets;
+
+        // only keep moves that give a direct or a discovered check
+        if (TType == QUIET_CHECKS) {
+            Bitboard checking = masks.check_squares[TPieceType];
+            if (bb::get(masks.discoverers, from)) {
+                checking |= ~attacks::getLine(masks.their_king_square, from);
+            }
+            attacks &= checking;
+        }
+
+        // the king may not move into check, other pieces must resolve checks
+        // and may only move along the line towards their own king when pinned
+        if (TType != PSEUDO_LEGAL && TPieceType == KING) {
+            attacks = getSafeKingTargets<TColor>(board, masks, attacks);
+        }
+        if (TPieceType != KING) {
+            attacks &= masks.evasions;
+            if (bb::get(masks.pinned, from)) {
+                attacks &= attacks::getLine(masks.king_square, from);
+            }
+        }
 
         // loop through all attacked squares
         while (attacks) {
@@ -66,17 +171,17 @@ static Move* generatePieceMoves(const Board& board, Move* movelist) {
         }
     }
 
-    // add castling moves for the king
-    if (TPieceType == KING) {
-        movelist = generateCastlingMoves<TColor>(board, movelist);
+    // add castling moves for the king, which is never possible when in check
+    if (TPieceType == KING && TType != CAPTURES && TType != EVASIONS && !masks.checkers) {
+        movelist = generateCastlingMoves<TType, TColor>(board, movelist);
     }
 
     return movelist;
 }
 
-template <Color TColor>
-static Move* generatePawnMoves(const Board& board, Move* movelist) {
-    
+template <GenerationType TType, Color TColor>
+static Move* generatePawnMoves(const Board& board, Move* movelist, const LegalityMasks& masks) {
+
     // get piece bitboards
     Bitboard theirPieces = board.getColorOccupancy(!TColor);
     Bitboard allPieces = board.getTotalOccupancy();
@@ -87,6 +192,7 @@ static Move* generatePawnMoves(const Board& board, Move* movelist) {
     constexpr Direction right_capture_dir = (TColor == WHITE) ? NORTHEAST : SOUTHWEST;
     constexpr Direction left_capture_dir = (TColor == WHITE) ? NORTHWEST : SOUTHEAST;
     constexpr Bitboard double_push_rank = (TColor == WHITE) ? RANK_3_BB : RANK_6_BB;
+    constexpr Bitboard promotion_rank = (TColor == WHITE) ? RANK_8_BB : RANK_1_BB;
 
     // get all possible target squares
     Bitboard single_pushes = (bb::shift<forward_dir>(pawns) & ~allPieces);
@@ -94,8 +200,39 @@ static Move* generatePawnMoves(const Board& board, Move* movelist) {
     Bitboard right_captures = bb::shift<right_capture_dir>(pawns);
     Bitboard left_captures = bb::shift<left_capture_dir>(pawns);
 
+    // restrict the target squares to the requested kind of moves, note that
+    // promotions are generated along with the captures
+    if (TType == CAPTURES) {
+        single_pushes &= promotion_rank;
+        double_pushes = 0ULL;
+    } else if (TType == QUIETS || TType == QUIET_CHECKS) {
+        single_pushes &= ~promotion_rank;
+        right_captures = 0ULL;
+        left_captures = 0ULL;
+    }
+
+    // only keep pushes that give a direct check or uncover an attack on the
+    // enemy king, which is the case unless the pawn is on the king's file
+    if (TType == QUIET_CHECKS) {
+        Bitboard their_king_file = FILE_A_BB << (masks.their_king_square & 7);
+        Bitboard discoverers = masks.discoverers & pawns & ~their_king_file;
+        Bitboard discovering_pushes = bb::shift<forward_dir>(discoverers);
+        single_pushes &= masks.check_squares[PAWN] | discovering_pushes;
+        double_pushes &= masks.check_squares[PAWN] | bb::shift<forward_dir>(discovering_pushes);
+    }
+
     // lambda function to generate the corresponding move for each target square
-    auto GatherMoves {[&movelist] (Bitboard targets, Direction dir, MoveFlag flag) {
+    auto GatherMoves {[&movelist, &masks] (Bitboard targets, Direction dir, MoveFlag flag) {
+        // only keep target squares that resolve a check
+        targets &= masks.evasions;
+
+        // lambda function to test whether a pinned pawn would leave its line
+        auto IsPinnedAway {[&masks] (Square from_square, Square to_square) {
+            return bb::get(masks.pinned, from_square)
+                && !bb::get(attacks::getLine(masks.king_square, from_square), to_square);
+        }
+        };
+
         // separate the target bitboard into non-promotion and promotion targets
         Bitboard promotions = targets & (RANK_1_BB | RANK_8_BB);
         Bitboard non_promotions = targets - promotions;
@@ -105,16 +242,18 @@ static Move* generatePawnMoves(const Board& board, Move* movelist) {
             // extract a target square and the corresponding origin square
             Square to_square = bb::popLSB(non_promotions);
             Square from_square = to_square - dir;
+            if (IsPinnedAway(from_square, to_square)) continue;
 
             // add the move to the moves list
             *movelist++ = Move(from_square, to_square, flag);
         }
-        
+
         // generate all promotion moves
         while(promotions) {
             // extract a target square and the corresponding origin square
             Square to_square = bb::popLSB(promotions);
             Square from_square = to_square - dir;
+            if (IsPinnedAway(from_square, to_square)) continue;
 
             // generate a separate move for promoting to any possible piece
             for (MoveFlag promotion_flag : {KNIGHT_PROMOTION, BISHOP_PROMOTION, ROOK_PROMOTION, QUEEN_PROMOTION}) {
@@ -131,25 +270,32 @@ static Move* generatePawnMoves(const Board& board, Move* movelist) {
     GatherMoves(right_captures & theirPieces, right_capture_dir, CAPTURE);
     GatherMoves(left_captures & theirPieces, left_capture_dir, CAPTURE);
 
-    // check for possible en-passant captures
+    // check for possible en-passant captures, which can uncover an attack on
+    // the king along the rank of both pawns and are thus fully tested instead
     Bitboard en_passant_target = board.getCurrentEnPassantTarget();
     if (en_passant_target) {
         int to_square = bb::getLSB(en_passant_target);
         if (right_captures & en_passant_target) {
             int from_square = to_square - right_capture_dir;
-            *movelist++ = Move(from_square, to_square, EN_PASSANT_CAPTURE);
+            Move move = Move(from_square, to_square, EN_PASSANT_CAPTURE);
+            if (TType == PSEUDO_LEGAL || board.isLegal(move)) {
+                *movelist++ = move;
+            }
         }
         if (left_captures & en_passant_target) {
             int from_square = to_square - left_capture_dir;
-            *movelist++ = Move(from_square, to_square, EN_PASSANT_CAPTURE);
+            Move move = Move(from_square, to_square, EN_PASSANT_CAPTURE);
+            if (TType == PSEUDO_LEGAL || board.isLegal(move)) {
+                *movelist++ = move;
+            }
         }
     }
 
     return movelist;
 }
 
-template <Color TColor>
-static Move* generateCastlingMoves(const Board& board, Move* movelist) {        // So far, will check for legality. This should however be moved to a board.isLegal(move) function
+template <GenerationType TType, Color TColor>
+static Move* generateCastlingMoves(const Board& board, Move* movelist) {        // castling moves are always tested for legality, also see Board::isLegal
 
     if (board.canCastle(TColor & ANY_CASTLING)) {
         for (const CastlingRight cr : {TColor & KINGSIDE_CASTLING, TColor & QUEENSIDE_CASTLING}) {
@@ -164,6 +310,16 @@ static Move* generateCastlingMoves(const Board& board, Move* movelist) {
                         allowed = false;
                     }
                 }
+                // when generating quiet checks, the rook must attack the enemy
+                // king from its target square next to the king
+                if (TType == QUIET_CHECKS && allowed) {
+                    Square rook_from = get_square(TColor * RANK_8, (from < to) ? FILE_H : FILE_A);
+                    Square rook_to = to - dir;
+                    Bitboard occupancy = (board.getTotalOccupancy() ^ bb::getBitboard(from) ^ bb::getBitboard(rook_from))
+                                       | bb::getBitboard(to) | bb::getBitboard(rook_to);
+                    Bitboard their_king = board.getPieceOccupancy(KING, !TColor);
+                    allowed = attacks::getPieceAttacks<ROOK>(rook_to, occupancy) & their_king;
+                }
                 if (allowed) {
                     if ((int)cr & (int)KINGSIDE_CASTLING) {
                         *movelist++ = Move(from, to, KINGSIDE_CASTLE);
@@ -178,6 +334,141 @@ static Move* generateCastlingMoves(const Board& board, Move* movelist) {
     return movelist;
 }
 
+template <Color TColor, PieceType TPieceType>
+static uint64_t countPieceMoves(const Board& board, const LegalityMasks& masks) {
+
+    assert(TPieceType != PAWN && TPieceType != KING);  // only for pieces without special moves
+
+    Bitboard our_pieces = board.getColorOccupancy(TColor);
+    Bitboard all_pieces = board.getTotalOccupancy();
+    Bitboard pieces = board.getPieceOccupancy(TPieceType, TColor);
+    uint64_t count = 0;
+
+    // count the legal target squares of each piece at once
+    while (pieces) {
+        Square from = bb::popLSB(pieces);
+        Bitboard attacks = attacks::getPieceAttacks<TPieceType>(from, all_pieces) & ~our_pieces & masks.evasions;
+        if (bb::get(masks.pinned, from)) {
+            attacks &= attacks::getLine(masks.king_square, from);
+        }
+        count += bb::count(attacks);
+    }
+
+    return count;
+}
+
+template <Color TColor>
+static uint64_t countAllMoves(const Board& board) {
+
+    LegalityMasks masks = getLegalityMasks<LEGAL, TColor>(board);
+    uint64_t count = 0;
+
+    Bitboard our_pieces = board.getColorOccupancy(TColor);
+    Bitboard their_pieces = board.getColorOccupancy(!TColor);
+    Bitboard all_pieces = board.getTotalOccupancy();
+
+    // in double check, only the king is allowed to move
+    if (bb::count(masks.checkers) < 2) {
+        constexpr Direction forward_dir = (TColor == WHITE) ? NORTH : SOUTH;
+        constexpr Direction right_capture_dir = (TColor == WHITE) ? NORTHEAST : SOUTHWEST;
+        constexpr Direction left_capture_dir = (TColor == WHITE) ? NORTHWEST : SOUTHEAST;
+        constexpr Bitboard double_push_rank = (TColor == WHITE) ? RANK_3_BB : RANK_6_BB;
+        constexpr Bitboard promotion_rank = (TColor == WHITE) ? RANK_8_BB : RANK_1_BB;
+
+        // lambda function to count the pawn moves of a set of pawns that may
+        // only move to the given target squares
+        auto CountPawnMoves {[&] (Bitboard pawns, Bitboard allowed) {
+            Bitboard single_pushes = bb::shift<forward_dir>(pawns) & ~all_pieces;
+            Bitboard double_pushes = bb::shift<forward_dir>(single_pushes & double_push_rank) & ~all_pieces;
+            Bitboard right_captures = bb::shift<right_capture_dir>(pawns) & their_pieces;
+            Bitboard left_captures = bb::shift<left_capture_dir>(pawns) & their_pieces;
+
+            Bitboard targets = (single_pushes | double_pushes) & masks.evasions & allowed;
+            Bitboard right_targets = right_captures & masks.evasions & allowed;
+            Bitboard left_targets = left_captures & masks.evasions & allowed;
+
+            // every promotion target yields four moves
+            return bb::count(targets) + bb::count(right_targets) + bb::count(left_targets)
+                 + 3 * (bb::count(targets & promotion_rank) + bb::count(right_targets & promotion_rank)
+                        + bb::count(left_targets & promotion_rank));
+        }
+        };
+
+        // unpinned pawns are counted at once, pinned ones along their line
+        Bitboard pawns = board.getPieceOccupancy(PAWN, TColor);
+        count += CountPawnMoves(pawns & ~masks.pinned, ~0ULL);
+        Bitboard pinned_pawns = pawns & masks.pinned;
+        while (pinned_pawns) {
+            Square from = bb::popLSB(pinned_pawns);
+            count += CountPawnMoves(bb::getBitboard(from), attacks::getLine(masks.king_square, from));
+        }
+
+        // en passant captures are rare and tested individually
+        Bitboard en_passant_target = board.getCurrentEnPassantTarget();
+        if (en_passant_target) {
+            Square to = bb::getLSB(en_passant_target);
+            Bitboard capturers = attacks::getPawnAttacks(to, !TColor) & pawns;
+            while (capturers) {
+                Square from = bb::popLSB(capturers);
+                count += board.isLegal(Move(from, to, EN_PASSANT_CAPTURE));
+            }
+        }
+
+        count += countPieceMoves<TColor, KNIGHT>(board, masks);
+        count += countPieceMoves<TColor, BISHOP>(board, masks);
+        count += countPieceMoves<TColor, ROOK>(board, masks);
+        count += countPieceMoves<TColor, QUEEN>(board, masks);
+    }
+
+    // the king may not move into check
+    Bitboard king_targets = attacks::getPieceAttacks<KING>(masks.king_square, all_pieces) & ~our_pieces;
+    count += bb::count(getSafeKingTargets<TColor>(board, masks, king_targets));
+
+    // castling moves are generated, there are at most two of them
+    if (!masks.checkers) {
+        Move castling_moves[2];
+        count += generateCastlingMoves<LEGAL, TColor>(board, castling_moves) - castling_moves;
+    }
+
+    return count;
+}
+
+/* @brief Remove all squares from the given king targets that are attacked by
+ *  the enemy. With attack maps, these are known except for the squares behind
+ *  the king, which are attacked through the square that the king is leaving.
+ * @param board A given chess board.
+ * @param masks The legality masks of the board.
+ * @param targets The squares the king could move to.
+ * @return The squares the king can move to without being in check. */
+template <Color TColor>
+static Bitboard getSafeKingTargets(const Board& board, const LegalityMasks& masks, Bitboard targets) {
+#ifdef USE_ATTACK_MAPS
+    targets &= ~board.getAttackedSquares(!TColor);
+    Bitboard sliders = masks.checkers & ~board.getPieceOccupancy(PAWN, !TColor) & ~board.getPieceOccupancy(KNIGHT, !TColor);
+    while (sliders) {
+        Square slider = bb::popLSB(sliders);
+        targets &= ~attacks::getLine(masks.king_square, slider) | bb::getBitboard(slider);
+    }
+    return targets;
+#else
+    // sliders attack through the square that the king is leaving
+    Bitboard their_pieces = board.getColorOccupancy(!TColor);
+    Bitboard occupancy = board.getTotalOccupancy() ^ bb::getBitboard(masks.king_square);
+    Bitboard safe = 0ULL;
+    while (targets) {
+        Square to = bb::popLSB(targets);
+        if (!(board.getAttackersTo(to, occupancy) & their_pieces)) {
+            bb::set(safe, to);
+        }
+    }
+    return safe;
+#endif
+}
+
 /* Explicit template instantiation. */
-template Move* generateAllMoves<WHITE>(const Board& board, Move* movelist);
-template Move* generateAllMoves<BLACK>(const Board& board, Move* movelist);
+template Move* generate<PSEUDO_LEGAL>(const Board& board, Move* movelist);
+template Move* generate<LEGAL>(const Board& board, Move* movelist);
+template Move* generate<CAPTURES>(const Board& board, Move* movelist);
+template Move* generate<QUIETS>(const Board& board, Move* movelist);
+template Move* generate<EVASIONS>(const Board& board, Move* movelist);
+template Move* generate<QUIET_CHECKS>(const Board& board, Move* movelist);
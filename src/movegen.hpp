@@ -6,17 +6,42 @@
 #include "attacks.hpp"
 #include "move.hpp"
 
-/* @brief Generate all possible pseudo-legal moves for the given board. The
-          moves are generated for the currently active side. This function can
-          be called directly, but is intended to be called from the constructor
-          of the move list itself.
+/* Types of move generation. Pseudo-legal moves may leave the own king in
+   check and have to be tested using Board::isLegal before being played, all
+   other types only generate legal moves. Captures (including all promotions)
+   and quiets together yield all legal moves, which allows a search to only
+   generate the quiet moves once the captures failed to produce a cutoff.
+   Evasions may only be generated when in check. */
+enum GenerationType {
+    PSEUDO_LEGAL,   // all pseudo-legal moves
+    LEGAL,          // all legal moves
+    CAPTURES,       // captures and promotions
+    QUIETS,         // non-capturing moves except for promotions
+    EVASIONS,       // all legal moves when in check
+    QUIET_CHECKS    // quiet moves that give check
+};
+
+/* @brief Generate all possible moves of the given type for the given board.
+          The moves are generated for the currently active side. This function
+          can be called directly, but is intended to be called from the
+          constructor of the move list itself.
+ * @tparam TType The type of moves to generate.
  * @param board A given chess board.
  * @param movelist A pointer to an existing move list.
  * @return A pointer to the last generated move in the list. */
+template <GenerationType TType>
 Move* generate(const Board& board, Move* movelist);
 
+/* @brief Count all legal moves for the given board without generating them.
+          Wherever possible, the moves are counted as the population count of
+          their target bitboards instead of being written to a list.
+ * @param board A given chess board.
+ * @return The number of legal moves for the currently active side. */
+uint64_t countLegalMoves(const Board& board);
+
 /* A list of moves, generated for a given board representation. The move
    generation is called from the constructor of this struct. */
+template <GenerationType TType = LEGAL>
 struct MoveList {
     private:
     Move m_moves[MAX_NUMBER_OF_MOVES];
@@ -24,12 +49,12 @@ struct MoveList {
 
     public:
     /* Constructor to conveniently generate a move list from a given board. */
-    explicit MoveList(const Board& board) : m_last(generate(board, m_moves)) {}
+    explicit MoveList(const Board& board) : m_last(generate<TType>(board, m_moves)) {}
 
     Move& operator[](size_t index) {
         return m_moves[index];
     }
-    
+
     const Move* begin() const { return m_moves; }
     const Move* end() const { return m_last; }
     size_t size() const { return m_last - m_moves; }
@@ -0,0 +1,181 @@
+#include "moveorder.hpp"
+
+namespace order {
+
+void Heuristics::clear() {
+    clearKillers();
+    std::fill(&m_counter_moves[0][0], &m_counter_moves[0][0] + N_PIECE_IDS * N_SQUARES, Move());
+    std::fill(&m_history[0][0][0], &m_history[0][0][0] + N_COLORS * N_SQUARES * N_SQUARES, 0);
+}
+
+void Heuristics::clearKillers() {
+    std::fill(&m_killers[0][0], &m_killers[0][0] + MAX_PLY * N_KILLERS, Move());
+}
+
+void Heuristics::update(const Board& board, Move move, Move previous, int ply, int depth,
+                        const Move* searched, int n_searched) {
+    // the most recent killer move comes first
+    if (m_killers[ply][0] != move) {
+        m_killers[ply][1] = m_killers[ply][0];
+        m_killers[ply][0] = move;
+    }
+    if (previous != Move()) {
+        m_counter_moves[board.getPieceOnSquare(previous.getTo())][previous.getTo()] = move;
+    }
+
+    // deeper cutoffs are more reliable and earn a larger bonus
+    Color us = board.getSideToMove();
+    int bonus = std::min(32 * depth * depth, MAX_HISTORY / 4);
+    applyBonus(m_history[us][move.getFrom()][move.getTo()], bonus);
+    for (int i = 0; i < n_searched; i++) {
+        applyBonus(m_history[us][searched[i].getFrom()][searched[i].getTo()], -bonus);
+    }
+}
+
+MovePicker::MovePicker(const Board& board, Move hash_move, const Heuristics& heuristics, int ply, Move previous)
+    : m_board(board), m_heuristics(heuristics), m_stage(HASH_MOVE), m_hash_move(hash_move) {
+    m_refutations[m_n_refutations++] = heuristics.getKiller(ply, 0);
+    m_refutations[m_n_refutations++] = heuristics.getKiller(ply, 1);
+    m_refutations[m_n_refutations++] = heuristics.getCounterMove(board, previous);
+}
+
+MovePicker::MovePicker(const Board& board, const Heuristics& heuristics)
+    : m_board(board), m_heuristics(heuristics),
+      m_stage(board.getCheckers() ? GENERATE_EVASIONS : GENERATE_QUIESCENCE_CAPTURES) {}
+
+template <GenerationType TType, typename TScore>
+void MovePicker::generateStage(TScore score) {
+    Move moves[MAX_NUMBER_OF_MOVES];
+    Move* last = generate<TType>(m_board, moves);
+    m_current = m_end = m_bad_captures_end;
+    for (Move* it = moves; it != last; it++) {
+        *m_end++ = ScoredMove{*it, score(*it)};
+    }
+}
+
+Move MovePicker::selectBest() {
+    ScoredMove* best = std::max_element(m_current, m_end,
+        [] (const ScoredMove& a, const ScoredMove& b) { return a.score < b.score; });
+    std::swap(*best, *m_current);
+    return (m_current++)->move;
+}
+
+Move MovePicker::next() {
+    switch (m_stage) {
+        case HASH_MOVE:
+            m_stage = GENERATE_CAPTURES;
+            if (m_hash_move != Move() && m_board.isPseudoLegal(m_hash_move) && m_board.isLegal(m_hash_move)) {
+                return m_hash_move;
+            }
+            m_hash_move = Move();
+            [[fallthrough]];
+
+        case GENERATE_CAPTURES:
+            generateStage<CAPTURES>([this] (Move move) { return getCaptureScore(m_board, move); });
+            m_stage = GOOD_CAPTURES;
+            [[fallthrough]];
+
+        case GOOD_CAPTURES:
+            // losing captures are deferred until after the quiet moves
+            while (m_current != m_end) {
+                Move move = selectBest();
+                if (move == m_hash_move) {
+                    continue;
+                }
+                if (!m_board.see(move)) {
+                    (m_bad_captures_end++)->move = move;
+                    continue;
+                }
+                return move;
+            }
+            m_stage = REFUTATIONS;
+            [[fallthrough]];
+
+        case REFUTATIONS:
+            // refutations found in other positions are only played once, and
+            // only if they are legal quiet moves in this one
+            while (m_refutation_index < m_n_refutations) {
+                const Move* refutation = m_refutations + m_refutation_index++;
+                Move move = *refutation;
+                bool is_duplicate = move == m_hash_move || std::find<const Move*>(m_refutations, refutation, move) != refutation;
+                if (move != Move() && !is_duplicate && !move.isCapture() && !move.isPromotion()
+                    && m_board.isPseudoLegal(move) && m_board.isLegal(move)) {
+                    return move;
+                }
+            }
+            m_stage = GENERATE_QUIETS;
+            [[fallthrough]];
+
+        case GENERATE_QUIETS: {
+            Color us = m_board.getSideToMove();
+            generateStage<QUIETS>([this, us] (Move move) { return m_heuristics.getHistory(us, move); });
+            m_stage = QUIET_MOVES;
+            [[fallthrough]];
+        }
+
+        case QUIET_MOVES:
+            while (m_current != m_end) {
+                Move move = selectBest();
+                if (!isPicked(move)) {
+                    return move;
+                }
+            }
+            m_current = m_moves;
+            m_stage = BAD_CAPTURES;
+            [[fallthrough]];
+
+        case BAD_CAPTURES:
+            // in the order in which they were deferred, which is by victim
+            if (m_current != m_bad_captures_end) {
+                return (m_current++)->move;
+            }
+            m_stage = DONE;
+            return Move();
+
+        case GENERATE_EVASIONS: {
+            Color us = m_board.getSideToMove();
+            generateStage<EVASIONS>([this, us] (Move move) {
+                return (move.isCapture() || move.isPromotion())
+                    ? EVASION_CAPTURE_SCORE + getCaptureScore(m_board, move) : m_heuristics.getHistory(us, move);
+            });
+            m_stage = EVASION_MOVES;
+            [[fallthrough]];
+        }
+
+        case EVASION_MOVES:
+            if (m_current != m_end) {
+                return selectBest();
+            }
+            m_stage = DONE;
+            return Move();
+
+        case GENERATE_QUIESCENCE_CAPTURES:
+            generateStage<CAPTURES>([this] (Move move) { return getCaptureScore(m_board, move); });
+            m_stage = QUIESCENCE_CAPTURES;
+            [[fallthrough]];
+
+        case QUIESCENCE_CAPTURES:
+            // losing captures are not searched at all
+            while (m_current != m_end) {
+                Move move = selectBest();
+                if (m_board.see(move)) {
+                    return move;
+                }
+            }
+            m_stage = DONE;
+            [[fallthrough]];
+
+        case DONE:
+            return Move();
+    }
+    return Move();
+}
+
+int MovePicker::getCaptureScore(const Board& board, Move move) {
+    PieceType victim = move.isEnPassantCapture() ? static_cast<PieceType>(PAWN) : type_of(board.getPieceOnSquare(move.getTo()));
+    PieceType attacker = type_of(board.getPieceOnSquare(move.getFrom()));
+    int promotion = move.isPromotion() ? PIECE_VALUES[move.getPromotionPieceType()] : 0;
+    return 8 * (PIECE_VALUES[victim] + promotion) - attacker;
+}
+
+}   // namespace order
@@ -0,0 +1,165 @@
+#ifndef MOVEORDER_HPP
+#define MOVEORDER_HPP
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdint.h>
+#include "board.hpp"
+#include "move.hpp"
+#include "movegen.hpp"
+#include "types.hpp"
+
+namespace order {
+
+const int N_KILLERS = 2;                // killer moves per ply
+const int MAX_HISTORY = 16384;          // bound of the history scores
+
+/* Move ordering tables learned during a search, which belong to a single
+   search thread. The killer moves are quiet moves that caused a cutoff at
+   the same ply in a sibling node, the counter moves are quiet moves that
+   refuted a given previous move, and the butterfly history accumulates how
+   often a quiet move from one square to another caused a cutoff, with
+   gravity updates that keep the scores within MAX_HISTORY and let recent
+   results outweigh old ones. */
+class Heuristics {
+    public:
+    Heuristics() { clear(); }
+
+    /* @brief Reset all tables, at the start of a new game. */
+    void clear();
+
+    /* @brief Reset the killer moves, which refer to the plies of the previous
+     *  search, at the start of a new search. */
+    void clearKillers();
+
+    /* @brief Reward a quiet move that caused a cutoff and penalise the quiet
+     *  moves that were searched before it without causing one.
+     * @param board The board of the node, with the move not yet played.
+     * @param move The move that caused the cutoff.
+     * @param previous The move that led to the node, or an empty move.
+     * @param ply The distance of the node from the root.
+     * @param depth The remaining depth of the node.
+     * @param searched The quiet moves searched before the cutoff.
+     * @param n_searched The number of quiet moves searched before the cutoff. */
+    void update(const Board& board, Move move, Move previous, int ply, int depth,
+                const Move* searched, int n_searched);
+
+    Move getKiller(int ply, int index) const { return m_killers[ply][index]; }
+    Move getCounterMove(const Board& board, Move previous) const {
+        return previous == Move() ? Move() : m_counter_moves[board.getPieceOnSquare(previous.getTo())][previous.getTo()];
+    }
+    int getHistory(Color color, Move move) const { return m_history[color][move.getFrom()][move.getTo()]; }
+
+    private:
+    Move m_killers[MAX_PLY][N_KILLERS];
+    Move m_counter_moves[N_PIECE_IDS][N_SQUARES];
+    int16_t m_history[N_COLORS][N_SQUARES][N_SQUARES];
+
+    /* @brief Apply a bonus to a history score, scaled down the closer the
+     *  score already is to the bound in the direction of the bonus. */
+    static void applyBonus(int16_t& score, int bonus) {
+        score += bonus - score * std::abs(bonus) / MAX_HISTORY;
+    }
+};
+
+/* Legal moves of a position in the order in which they are searched. The
+   moves are generated in stages, so that a cutoff by an early move saves
+   generating and scoring the later ones. The order is the hash move, the
+   captures and promotions ranked by the most valuable victim and the least
+   valuable attacker, the killer moves, the counter move, the other quiet
+   moves ranked by their history and finally the captures that lose material.
+   Within a stage, the best remaining move is selected on each call of next,
+   and the static exchange evaluation of a capture is only computed once it
+   is selected. Moves that are not generated by the picker itself, like the
+   hash move, are tested for legality first. */
+class MovePicker {
+    public:
+    /* @brief Set up the stages of a position of the main search.
+     * @param board The board of the node.
+     * @param hash_move The move stored in the transposition table, or empty.
+     * @param heuristics The ordering tables of the searching thread.
+     * @param ply The distance of the node from the root.
+     * @param previous The move that led to the node, or empty. */
+    MovePicker(const Board& board, Move hash_move, const Heuristics& heuristics, int ply, Move previous);
+
+    /* @brief Set up the stages of a quiescence search node, which are all
+     *  evasions when in check and otherwise only the captures and promotions
+     *  that do not lose material.
+     * @param board The board of the node.
+     * @param heuristics The ordering tables of the searching thread. */
+    MovePicker(const Board& board, const Heuristics& heuristics);
+
+    /* @brief Select the best remaining move, advancing to the next stage once
+     *  the current one is exhausted.
+     * @return The move, or an empty move if all moves have been picked. */
+    Move next();
+
+    private:
+    struct ScoredMove {
+        Move move;
+        int score;
+    };
+
+    enum Stage : uint8_t {
+        HASH_MOVE,
+        GENERATE_CAPTURES,
+        GOOD_CAPTURES,
+        REFUTATIONS,
+        GENERATE_QUIETS,
+        QUIET_MOVES,
+        BAD_CAPTURES,
+        GENERATE_EVASIONS,
+        EVASION_MOVES,
+        GENERATE_QUIESCENCE_CAPTURES,
+        QUIESCENCE_CAPTURES,
+        DONE
+    };
+
+    // evasions that capture are searched before all quiet evasions, whose
+    // history scores lie within MAX_HISTORY
+    static constexpr int EVASION_CAPTURE_SCORE = 1 << 28;
+
+    const Board& m_board;
+    const Heuristics& m_heuristics;
+    Stage m_stage;
+    Move m_hash_move;
+    Move m_refutations[N_KILLERS + 1];      // the killer moves and the counter move
+    int m_n_refutations = 0;
+    int m_refutation_index = 0;
+
+    /* Moves of the current stage, from which the remaining moves between the
+       current and the end pointer are picked. The losing captures are moved
+       to the front of the array once they are found, where they stay while
+       the quiet moves are generated behind them. */
+    ScoredMove m_moves[MAX_NUMBER_OF_MOVES];
+    ScoredMove* m_current = m_moves;
+    ScoredMove* m_end = m_moves;
+    ScoredMove* m_bad_captures_end = m_moves;
+
+    /* @brief Generate the moves of a stage behind the losing captures and
+     *  score them.
+     * @tparam TType The type of moves to generate.
+     * @tparam TScore Scores a generated move. */
+    template <GenerationType TType, typename TScore>
+    void generateStage(TScore score);
+
+    /* @brief Move the best remaining move of the current stage to the
+     *  current position and advance past it.
+     * @return The selected move. */
+    Move selectBest();
+
+    /* @brief Test whether a move may have been picked in the stages before
+     *  the generated ones, where illegal refutations are never generated. */
+    bool isPicked(Move move) const {
+        return move == m_hash_move || std::find(m_refutations, m_refutations + m_n_refutations, move) != m_refutations + m_n_refutations;
+    }
+
+    /* @brief Score a capture or promotion by its victim and attacker.
+     * @return A score that is higher for more valuable victims and, among
+     *  those, for less valuable attackers. */
+    static int getCaptureScore(const Board& board, Move move);
+};
+
+}   // namespace order
+
+#endif
@@ -0,0 +1,338 @@
+#include "nnue.hpp"
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+#include "board.hpp"
+#include "exceptions.hpp"
+
+#ifdef USE_AVX2
+#include <immintrin.h>
+#endif
+
+namespace nnue {
+
+std::unique_ptr<Network> loaded_network;
+uint32_t loaded_generation = 0;
+
+/* Values of both sides for every king square, together with the pieces they
+   were computed for. */
+struct RefreshCache {
+    struct Entry {
+        alignas(32) int16_t values[N_HIDDEN];
+        Bitboard pieces[N_COLORS][N_PIECE_TYPES];
+    };
+    Entry entries[N_COLORS][N_SQUARES];
+    uint32_t generation = 0;    // network the entries belong to
+};
+
+// each search thread refreshes with its own cache
+static thread_local RefreshCache refresh_cache;
+
+/* @brief Read values from a stream, throwing if the stream ends early.
+ * @param stream The stream.
+ * @param data The array to read into.
+ * @param count The number of values to read. */
+template <typename T>
+static void read(std::istream& stream, T* data, size_t count) {
+    stream.read(reinterpret_cast<char*>(data), std::streamsize(sizeof(T) * count));
+    if (!stream) {
+        throw InvalidNetworkException("The network file ends unexpectedly.");
+    }
+}
+
+void load(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw InvalidNetworkException("The network file " + path + " cannot be opened.");
+    }
+    load(stream);
+}
+
+void load(std::istream& stream) {
+    // the header holds the version, a hash of the architecture and its
+    // description, then each part starts with its own hash, which are not
+    // checked since the exact size of the file already fixes the architecture
+    uint32_t version, hash, description_size;
+    read(stream, &version, 1);
+    read(stream, &hash, 1);
+    read(stream, &description_size, 1);
+    if (version != VERSION) {
+        throw InvalidNetworkException("The network file has an unknown version.");
+    }
+    std::string description(description_size, '\0');
+    read(stream, description.data(), description_size);
+
+    std::unique_ptr<Network> network = std::make_unique<Network>();
+    read(stream, &hash, 1);
+    read(stream, network->feature_biases, N_HIDDEN);
+    read(stream, network->feature_weights, size_t(N_FEATURES) * N_HIDDEN);
+    read(stream, &hash, 1);
+    read(stream, network->biases_1, N_LAYER_1);
+    read(stream, network->weights_1, N_LAYER_1 * N_INPUTS);
+    read(stream, network->biases_2, N_LAYER_2);
+    read(stream, network->weights_2, N_LAYER_2 * N_LAYER_1);
+    read(stream, &network->output_bias, 1);
+    read(stream, network->output_weights, N_LAYER_2);
+    if (stream.peek() != std::istream::traits_type::eof()) {
+        throw InvalidNetworkException("The network file does not match the architecture.");
+    }
+
+    loaded_network = std::move(network);
+    loaded_generation++;
+}
+
+void unload() {
+    loaded_network.reset();
+    loaded_generation++;
+}
+
+Accumulator computeAccumulator(const Board& board) {
+    const Network& network = *loaded_network;
+    Accumulator accumulator;
+    accumulator.generation = loaded_generation;
+    for (Color perspective : {WHITE, BLACK}) {
+        int16_t* values = accumulator.values[perspective];
+        std::copy(network.feature_biases, network.feature_biases + N_HIDDEN, values);
+        Square king = board.getKingSquare(perspective);
+        Bitboard pieces = board.getTotalOccupancy() & ~board.getPieceOccupancy(KING, WHITE)
+                        & ~board.getPieceOccupancy(KING, BLACK);
+        while (pieces) {
+            Square square = bb::popLSB(pieces);
+            Feature feature = getFeature(perspective, king, board.getPieceOnSquare(square), square);
+            const int16_t* column = &network.feature_weights[size_t(feature) * N_HIDDEN];
+            for (int i = 0; i < N_HIDDEN; i++) {
+                values[i] += column[i];
+            }
+        }
+    }
+    return accumulator;
+}
+
+/* @brief Add and remove the columns of features to and from values.
+ * @param values The values of one side.
+ * @param added The features to add.
+ * @param n_added The number of features to add.
+ * @param removed The features to remove.
+ * @param n_removed The number of features to remove. */
+static void applyFeatures(int16_t* values, const Feature* added, int n_added, const Feature* removed, int n_removed) {
+    const int16_t* weights = loaded_network->feature_weights;
+#ifdef USE_AVX2
+    // all values fit into the sixteen registers, so they are loaded and
+    // stored once for all features
+    const int n_registers = N_HIDDEN / 16;
+    __m256i sums[n_registers];
+    __m256i* vectors = reinterpret_cast<__m256i*>(values);
+    for (int j = 0; j < n_registers; j++) {
+        sums[j] = _mm256_load_si256(&vectors[j]);
+    }
+    for (int i = 0; i < n_added; i++) {
+        const __m256i* column = reinterpret_cast<const __m256i*>(&weights[size_t(added[i]) * N_HIDDEN]);
+        for (int j = 0; j < n_registers; j++) {
+            sums[j] = _mm256_add_epi16(sums[j], _mm256_load_si256(&column[j]));
+        }
+    }
+    for (int i = 0; i < n_removed; i++) {
+        const __m256i* column = reinterpret_cast<const __m256i*>(&weights[size_t(removed[i]) * N_HIDDEN]);
+        for (int j = 0; j < n_registers; j++) {
+            sums[j] = _mm256_sub_epi16(sums[j], _mm256_load_si256(&column[j]));
+        }
+    }
+    for (int j = 0; j < n_registers; j++) {
+        _mm256_store_si256(&vectors[j], sums[j]);
+    }
+#else
+    for (int i = 0; i < n_added; i++) {
+        const int16_t* column = &weights[size_t(added[i]) * N_HIDDEN];
+        for (int j = 0; j < N_HIDDEN; j++) {
+            values[j] += column[j];
+        }
+    }
+    for (int i = 0; i < n_removed; i++) {
+        const int16_t* column = &weights[size_t(removed[i]) * N_HIDDEN];
+        for (int j = 0; j < N_HIDDEN; j++) {
+            values[j] -= column[j];
+        }
+    }
+#endif
+}
+
+void update(Accumulator& accumulator, Color perspective, const Changes& changes) {
+    applyFeatures(accumulator.values[perspective], changes.added, changes.n_added, changes.removed, changes.n_removed);
+}
+
+void refresh(Accumulator& accumulator, const Board& board, Color perspective) {
+    // start over with the biases and no pieces for a new network
+    RefreshCache& cache = refresh_cache;
+    if (cache.generation != loaded_generation) {
+        for (Color color : {WHITE, BLACK}) {
+            for (Square square = 0; square < N_SQUARES; square++) {
+                RefreshCache::Entry& entry = cache.entries[color][square];
+                std::copy(loaded_network->feature_biases, loaded_network->feature_biases + N_HIDDEN, entry.values);
+                memset(entry.pieces, 0, sizeof(entry.pieces));
+            }
+        }
+        cache.generation = loaded_generation;
+    }
+
+    // update the entry of the king square by the pieces that have changed
+    Square king = board.getKingSquare(perspective);
+    RefreshCache::Entry& entry = cache.entries[perspective][king];
+    Feature added[MAX_ACTIVE];
+    Feature removed[MAX_ACTIVE];
+    int n_added = 0;
+    int n_removed = 0;
+    for (Color color : {WHITE, BLACK}) {
+        for (PieceType pieceType = PAWN; pieceType < KING; pieceType++) {
+            Piece piece = make_piece(color, pieceType);
+            Bitboard pieces = board.getPieceOccupancy(pieceType, color);
+            Bitboard cached = entry.pieces[color][pieceType];
+            for (Bitboard gone = cached & ~pieces; gone; ) {
+                removed[n_removed++] = getFeature(perspective, king, piece, bb::popLSB(gone));
+            }
+            for (Bitboard come = pieces & ~cached; come; ) {
+                added[n_added++] = getFeature(perspective, king, piece, bb::popLSB(come));
+            }
+            entry.pieces[color][pieceType] = pieces;
+        }
+    }
+    applyFeatures(entry.values, added, n_added, removed, n_removed);
+    std::copy(entry.values, entry.values + N_HIDDEN, accumulator.values[perspective]);
+    accumulator.generation = loaded_generation;
+}
+
+/* @brief Clip the values of both sides to [0, 127] as the input of the first
+ *  layer, with the side to move first.
+ * @param accumulator The accumulator.
+ * @param side_to_move The side to move.
+ * @param input The input of the first layer. */
+static void transformScalar(const Accumulator& accumulator, Color side_to_move, uint8_t* input) {
+    for (Color perspective : {side_to_move, Color(!side_to_move)}) {
+        const int16_t* values = accumulator.values[perspective];
+        for (int i = 0; i < N_HIDDEN; i++) {
+            *input++ = uint8_t(std::clamp(int(values[i]), 0, 127));
+        }
+    }
+}
+
+/* @brief Compute the outputs of a layer from its inputs.
+ * @tparam TInputs The number of inputs.
+ * @tparam TOutputs The number of outputs.
+ * @param input The inputs.
+ * @param weights The weights, one row of inputs per output.
+ * @param biases The biases.
+ * @param output The outputs. */
+template <int TInputs, int TOutputs>
+static void affineScalar(const uint8_t* input, const int8_t* weights, const int32_t* biases, int32_t* output) {
+    for (int i = 0; i < TOutputs; i++) {
+        int32_t sum = biases[i];
+        for (int j = 0; j < TInputs; j++) {
+            sum += int32_t(weights[i * TInputs + j]) * input[j];
+        }
+        output[i] = sum;
+    }
+}
+
+/* @brief Scale the outputs of a hidden layer down and clip them to [0, 127]
+ *  as the inputs of the next layer.
+ * @tparam TSize The number of outputs.
+ * @param output The outputs.
+ * @param input The inputs of the next layer. */
+template <int TSize>
+static void clip(const int32_t* output, uint8_t* input) {
+    for (int i = 0; i < TSize; i++) {
+        input[i] = uint8_t(std::clamp(output[i] >> WEIGHT_SCALE_BITS, 0, 127));
+    }
+}
+
+/* @brief Turn the output of the network into centipawns. */
+static Value toCentipawns(int32_t output) {
+    return Value(output / OUTPUT_SCALE * 100 / PAWN_VALUE);
+}
+
+Value propagateScalar(const Accumulator& accumulator, Color side_to_move) {
+    const Network& network = *loaded_network;
+    uint8_t input[N_INPUTS];
+    int32_t output_1[N_LAYER_1];
+    uint8_t input_2[N_LAYER_1];
+    int32_t output_2[N_LAYER_2];
+    uint8_t input_3[N_LAYER_2];
+    int32_t output;
+    transformScalar(accumulator, side_to_move, input);
+    affineScalar<N_INPUTS, N_LAYER_1>(input, network.weights_1, network.biases_1, output_1);
+    clip<N_LAYER_1>(output_1, input_2);
+    affineScalar<N_LAYER_1, N_LAYER_2>(input_2, network.weights_2, network.biases_2, output_2);
+    clip<N_LAYER_2>(output_2, input_3);
+    affineScalar<N_LAYER_2, 1>(input_3, network.output_weights, &network.output_bias, &output);
+    return toCentipawns(output);
+}
+
+#ifdef USE_AVX2
+/* @brief Clip the values of both sides to [0, 127] like above, sixteen at a
+ *  time. Packing saturates to [-128, 127] and interleaves the halves of both
+ *  registers, which the final permutation puts back in order. */
+static void transform(const Accumulator& accumulator, Color side_to_move, uint8_t* input) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i* output = reinterpret_cast<__m256i*>(input);
+    for (Color perspective : {side_to_move, Color(!side_to_move)}) {
+        const __m256i* values = reinterpret_cast<const __m256i*>(accumulator.values[perspective]);
+        for (int i = 0; i < N_HIDDEN / 32; i++) {
+            __m256i packed = _mm256_packs_epi16(_mm256_load_si256(&values[2 * i]), _mm256_load_si256(&values[2 * i + 1]));
+            _mm256_store_si256(output++, _mm256_permute4x64_epi64(_mm256_max_epi8(packed, zero), 0b11011000));
+        }
+    }
+}
+
+/* @brief Compute the outputs of a layer like above, 32 inputs at a time.
+ *  The products of unsigned inputs and signed weights are summed up in pairs
+ *  to int16, which cannot saturate since the inputs are at most 127, and
+ *  then in pairs to int32. */
+template <int TInputs, int TOutputs>
+static void affine(const uint8_t* input, const int8_t* weights, const int32_t* biases, int32_t* output) {
+    static_assert(TInputs % 32 == 0);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i* inputs = reinterpret_cast<const __m256i*>(input);
+    for (int i = 0; i < TOutputs; i++) {
+        const __m256i* row = reinterpret_cast<const __m256i*>(&weights[i * TInputs]);
+        __m256i sum = _mm256_setzero_si256();
+        for (int j = 0; j < TInputs / 32; j++) {
+            __m256i products = _mm256_maddubs_epi16(_mm256_load_si256(&inputs[j]), _mm256_load_si256(&row[j]));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0b01001110));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0b10110001));
+        output[i] = biases[i] + _mm_cvtsi128_si32(half);
+    }
+}
+
+Value propagate(const Accumulator& accumulator, Color side_to_move) {
+    const Network& network = *loaded_network;
+    alignas(32) uint8_t input[N_INPUTS];
+    alignas(32) int32_t output_1[N_LAYER_1];
+    alignas(32) uint8_t input_2[N_LAYER_1];
+    alignas(32) int32_t output_2[N_LAYER_2];
+    alignas(32) uint8_t input_3[N_LAYER_2];
+    int32_t output;
+    transform(accumulator, side_to_move, input);
+    affine<N_INPUTS, N_LAYER_1>(input, network.weights_1, network.biases_1, output_1);
+    clip<N_LAYER_1>(output_1, input_2);
+    affine<N_LAYER_1, N_LAYER_2>(input_2, network.weights_2, network.biases_2, output_2);
+    clip<N_LAYER_2>(output_2, input_3);
+    affine<N_LAYER_2, 1>(input_3, network.output_weights, &network.output_bias, &output);
+    return toCentipawns(output);
+}
+#else
+Value propagate(const Accumulator& accumulator, Color side_to_move) {
+    return propagateScalar(accumulator, side_to_move);
+}
+#endif
+
+Value evaluate(const Board& board) {
+    const Accumulator& accumulator = board.getNetworkAccumulator();
+    if (accumulator.generation != loaded_generation) {
+        return propagate(computeAccumulator(board), board.getSideToMove());
+    }
+    return propagate(accumulator, board.getSideToMove());
+}
+
+}   // namespace nnue
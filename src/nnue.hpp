@@ -0,0 +1,157 @@
+#ifndef NNUE_HPP
+#define NNUE_HPP
+
+#include <istream>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include "types.hpp"
+
+class Board;
+
+namespace nnue {
+
+// architecture of the networks of Stockfish 12 and 13, whose files can be
+// loaded: HalfKP features, i.e. the own king square combined with the square
+// of every other piece but the kings, transformed into N_HIDDEN values for
+// each side, followed by two hidden layers and a single output
+const uint32_t VERSION = 0x7AF32F16;
+const int N_PIECE_SQUARES = 10 * N_SQUARES + 1;         // own and enemy pieces by square, index 0 is unused
+const int N_FEATURES = N_SQUARES * N_PIECE_SQUARES;     // piece squares for every own king square
+const int N_HIDDEN = 256;                               // values of the accumulator of each side
+const int N_INPUTS = 2 * N_HIDDEN;                      // accumulators of the side to move and the other side
+const int N_LAYER_1 = 32;
+const int N_LAYER_2 = 32;
+
+// the outputs of the hidden layers are shifted by WEIGHT_SCALE_BITS and
+// clipped to [0, 127], the output is divided by OUTPUT_SCALE, after which a
+// pawn in the endgame is worth PAWN_VALUE
+const int WEIGHT_SCALE_BITS = 6;
+const int OUTPUT_SCALE = 16;
+const int PAWN_VALUE = 208;
+
+// features added or removed by a single move from the view of one side, a
+// capture removes both the moving and the captured piece
+const int MAX_CHANGES = 2;
+const int MAX_ACTIVE = 30;                              // all pieces but the kings
+
+typedef uint32_t Feature;
+
+/* Parameters of a network, with the weights of the feature transformer
+   stored as one column of N_HIDDEN values per feature. */
+struct Network {
+    alignas(32) int16_t feature_biases[N_HIDDEN];
+    alignas(32) int16_t feature_weights[N_FEATURES * N_HIDDEN];
+    alignas(32) int32_t biases_1[N_LAYER_1];
+    alignas(32) int8_t weights_1[N_LAYER_1 * N_INPUTS];
+    alignas(32) int32_t biases_2[N_LAYER_2];
+    alignas(32) int8_t weights_2[N_LAYER_2 * N_LAYER_1];
+    int32_t output_bias;
+    alignas(32) int8_t output_weights[N_LAYER_2];
+};
+
+/* Sums of the feature transformer over all active features, from the view
+   of each side. */
+struct Accumulator {
+    alignas(32) int16_t values[N_COLORS][N_HIDDEN];
+    uint32_t generation = 0;                            // network the values belong to, zero for none
+
+    bool operator==(const Accumulator& other) const = default;
+};
+
+/* Features added and removed by a move from the view of one side. */
+struct Changes {
+    Feature added[MAX_CHANGES] = {};
+    Feature removed[MAX_CHANGES] = {};
+    int n_added = 0;
+    int n_removed = 0;
+
+    void add(Feature feature) { added[n_added++] = feature; }
+    void remove(Feature feature) { removed[n_removed++] = feature; }
+};
+
+// the loaded network, and a counter that is increased whenever it changes,
+// which tells accumulators of an earlier network apart
+extern std::unique_ptr<Network> loaded_network;
+extern uint32_t loaded_generation;
+
+/* @brief Test whether a network is loaded, which then replaces the classical
+ *  evaluation. */
+inline bool isLoaded() { return loaded_network != nullptr; }
+
+/* @brief Get the generation of the loaded network. */
+inline uint32_t getGeneration() { return loaded_generation; }
+
+/* @brief Load a network from a file, which replaces the loaded one. Throws
+ *  an InvalidNetworkException if the file cannot be read or does not match
+ *  the architecture, in which case the loaded network is kept.
+ * @param path The path of the file. */
+void load(const std::string& path);
+
+/* @brief Load a network from a stream like above.
+ * @param stream The stream, in little-endian byte order. */
+void load(std::istream& stream);
+
+/* @brief Unload the network, which restores the classical evaluation. */
+void unload();
+
+/* @brief Get the feature of a piece from the view of one side.
+ * @param perspective The side whose view to take, whose board is rotated by
+ *  180 degrees for black.
+ * @param king The square of the king of that side.
+ * @param piece The piece, which must not be a king.
+ * @param square The square of the piece.
+ * @return The index of the feature. */
+inline Feature getFeature(Color perspective, Square king, Piece piece, Square square) {
+    int flip = (perspective == WHITE) ? 0 : N_SQUARES - 1;
+    int offset = 1 + (2 * (type_of(piece) - PAWN) + (color_of(piece) != perspective)) * N_SQUARES;
+    return Feature((square ^ flip) + offset + N_PIECE_SQUARES * (king ^ flip));
+}
+
+/* @brief Compute the accumulator of a board from scratch, summing up the
+ *  columns of all active features one by one.
+ * @param board The board.
+ * @return The accumulator of the loaded network. */
+Accumulator computeAccumulator(const Board& board);
+
+/* @brief Recompute the values of one side after its king has moved, which
+ *  changes all of its features. Each thread keeps the values of both sides
+ *  for every king square together with the pieces they were computed for,
+ *  so only the pieces that have changed since the king stood on the square
+ *  before need to be added or removed.
+ * @param accumulator The accumulator to update.
+ * @param board The board.
+ * @param perspective The side whose values to recompute. */
+void refresh(Accumulator& accumulator, const Board& board, Color perspective);
+
+/* @brief Add and remove the columns of the changed features, with AVX2 when
+ *  built with USE_AVX2 and with the scalar fallback otherwise.
+ * @param accumulator The accumulator to update.
+ * @param perspective The side whose values to update.
+ * @param changes The changed features of that side. */
+void update(Accumulator& accumulator, Color perspective, const Changes& changes);
+
+/* @brief Propagate an accumulator through the layers of the network, with
+ *  int8 and int16 AVX2 kernels when built with USE_AVX2 and with the scalar
+ *  fallback otherwise.
+ * @param accumulator The accumulator of the loaded network.
+ * @param side_to_move The side to move.
+ * @return The score in centipawns from the perspective of the side to move. */
+Value propagate(const Accumulator& accumulator, Color side_to_move);
+
+/* @brief Propagate an accumulator through the layers one value at a time.
+ * @param accumulator The accumulator of the loaded network.
+ * @param side_to_move The side to move.
+ * @return The score in centipawns from the perspective of the side to move. */
+Value propagateScalar(const Accumulator& accumulator, Color side_to_move);
+
+/* @brief Evaluate a position with the loaded network, from the accumulator
+ *  maintained by the board, or from scratch if it belongs to an earlier
+ *  network.
+ * @param board The board to evaluate.
+ * @return The score in centipawns from the perspective of the side to move. */
+Value evaluate(const Board& board);
+
+}   // namespace nnue
+
+#endif
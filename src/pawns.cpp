@@ -0,0 +1,114 @@
+#include "pawns.hpp"
+
+namespace pawns {
+
+/* @brief Fill each file of a bitboard from its set squares towards the
+ *  opponent's side of the given color.
+ * @tparam TColor The color that moves towards the opponent.
+ * @param b The bitboard to fill.
+ * @return The filled bitboard. */
+template <Color TColor>
+static constexpr Bitboard fillForward(Bitboard b) {
+    if constexpr (TColor == WHITE) {
+        b |= b << 8;
+        b |= b << 16;
+        b |= b << 32;
+    } else {
+        b |= b >> 8;
+        b |= b >> 16;
+        b |= b >> 32;
+    }
+    return b;
+}
+
+/* @brief Compute the attacks and the attack spans of the pawns of one side.
+ * @tparam TColor The color of the pawns.
+ * @param board The board.
+ * @param entry The entry to store the bitboards in. */
+template <Color TColor>
+static void computeAttacks(const Board& board, Entry& entry) {
+    constexpr Direction right_capture_dir = (TColor == WHITE) ? NORTHEAST : SOUTHWEST;
+    constexpr Direction left_capture_dir = (TColor == WHITE) ? NORTHWEST : SOUTHEAST;
+    Bitboard pawns = board.getPieceOccupancy(PAWN, TColor);
+    entry.attacks[TColor] = bb::shift<right_capture_dir>(pawns) | bb::shift<left_capture_dir>(pawns);
+    entry.attack_spans[TColor] = fillForward<TColor>(entry.attacks[TColor]);
+}
+
+/* @brief Evaluate the pawns of one side, which requires the attacks and
+ *  attack spans of both sides, and store the passed pawns.
+ * @tparam TColor The color of the pawns.
+ * @param board The board.
+ * @param entry The entry to store the passed pawns in.
+ * @return The score from the point of view of the given side. */
+template <Color TColor>
+static psqt::Score evaluateSide(const Board& board, Entry& entry) {
+    constexpr Color them = !TColor;
+    constexpr Direction forward_dir = (TColor == WHITE) ? NORTH : SOUTH;
+    constexpr Direction backward_dir = (TColor == WHITE) ? SOUTH : NORTH;
+    Bitboard ours = board.getPieceOccupancy(PAWN, TColor);
+    Bitboard theirs = board.getPieceOccupancy(PAWN, them);
+
+    // a pawn is passed if no enemy pawn can block or capture it on its way
+    Bitboard their_front_spans = fillForward<them>(bb::shift<backward_dir>(theirs));
+    entry.passed[TColor] = ours & ~(their_front_spans | entry.attack_spans[them]);
+
+    // isolated pawns have no own pawns on the neighbouring files, doubled
+    // pawns have an own pawn behind them on the same file
+    Bitboard files = fillForward<WHITE>(ours) | fillForward<BLACK>(ours);
+    Bitboard isolated = ours & ~(bb::shift<EAST>(files) | bb::shift<WEST>(files));
+    Bitboard doubled = ours & fillForward<TColor>(bb::shift<forward_dir>(ours));
+
+    // backward pawns cannot advance safely and no own pawn can ever defend
+    // their stop square, isolated pawns are already penalised
+    Bitboard unsafe_stops = bb::shift<forward_dir>(ours) & entry.attacks[them] & ~entry.attack_spans[TColor];
+    Bitboard backward = bb::shift<backward_dir>(unsafe_stops) & ~isolated;
+
+    psqt::Score score = ISOLATED * bb::count(isolated);
+    score += DOUBLED * bb::count(doubled);
+    score += BACKWARD * bb::count(backward);
+    Bitboard passed = entry.passed[TColor];
+    while (passed) {
+        Square square = bb::popLSB(passed);
+        int rank = (TColor == WHITE) ? square / N_FILES : N_RANKS - 1 - square / N_FILES;
+        score += PASSED[rank];
+    }
+    return score;
+}
+
+Value Entry::computeShelter(const Board& board, Color color) {
+    // count the own pawns on the king's and the neighbouring files, on the
+    // two ranks in front of the king
+    Bitboard pawns = board.getPieceOccupancy(PAWN, color);
+    Bitboard king = bb::getBitboard(board.getKingSquare(color));
+    Bitboard zone = king | bb::shift<EAST>(king) | bb::shift<WEST>(king);
+    Value shelter = 0;
+    for (Value bonus : SHELTER) {
+        zone = (color == WHITE) ? bb::shift<NORTH>(zone) : bb::shift<SOUTH>(zone);
+        shelter += bonus * bb::count(zone & pawns);
+    }
+    return shelter;
+}
+
+Entry evaluate(const Board& board) {
+    Entry entry;
+    entry.key = board.getPawnKey();
+    computeAttacks<WHITE>(board, entry);
+    computeAttacks<BLACK>(board, entry);
+    entry.score = evaluateSide<WHITE>(board, entry);
+    entry.score -= evaluateSide<BLACK>(board, entry);
+    return entry;
+}
+
+Entry& PawnTable::probe(const Board& board) {
+    Key key = board.getPawnKey();
+    Entry& entry = m_entries[key & (TABLE_SIZE - 1)];
+    m_probes.store(m_probes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (entry.key == key) {
+        m_hits.store(m_hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    } else {
+        entry = evaluate(board);
+    }
+    return entry;
+}
+
+}   // namespace pawns
@@ -0,0 +1,108 @@
+#ifndef PAWNS_HPP
+#define PAWNS_HPP
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include "bitboard.hpp"
+#include "board.hpp"
+#include "psqt.hpp"
+#include "types.hpp"
+
+namespace pawns {
+
+const size_t TABLE_SIZE = 1 << 14;      // entries per table, a power of two
+
+// scores of the pawn structure per pawn, from the point of view of its owner
+constexpr psqt::Score ISOLATED = {-10, -15};
+constexpr psqt::Score DOUBLED = {-10, -25};
+constexpr psqt::Score BACKWARD = {-8, -12};
+constexpr psqt::Score PASSED[N_RANKS] = {
+    {0, 0}, {5, 10}, {5, 15}, {10, 25}, {25, 45}, {40, 70}, {60, 110}, {0, 0}
+};
+
+// middlegame bonus per pawn in front of the own king, on the rank right in
+// front of it and on the rank after
+constexpr Value SHELTER[2] = {12, 6};
+
+/* Evaluation of the pawn structure of a position, which only depends on the
+   pawns and is therefore cached by the pawn key. Next to the score, the
+   entry keeps the pawn bitboards derived on the way, which are of use to
+   other evaluation terms. The shelter of a king depends on its square as
+   well and is computed on demand for the last king square asked for. */
+struct Entry {
+    Key key = 0;
+    psqt::Score score;                      // score of white's pawns minus black's
+    Bitboard attacks[N_COLORS] = {};        // squares attacked by the pawns of each side
+    Bitboard attack_spans[N_COLORS] = {};   // squares the pawns of each side may ever attack
+    Bitboard passed[N_COLORS] = {};         // pawns without enemy pawns in front of them
+    Square king_squares[N_COLORS] = {N_SQUARES, N_SQUARES};
+    Value shelter[N_COLORS] = {};
+
+    /* @brief Get the shelter of a king by the pawns in front of it, which is
+     *  cached for the king square.
+     * @param board The board, whose pawns must match the entry.
+     * @param color The color of the king.
+     * @return The middlegame bonus of the shelter. */
+    Value getShelter(const Board& board, Color color) {
+        Square king_square = board.getKingSquare(color);
+        if (king_squares[color] != king_square) {
+            king_squares[color] = king_square;
+            shelter[color] = computeShelter(board, color);
+        }
+        return shelter[color];
+    }
+
+    /* @brief Compute the shelter of a king from scratch.
+     * @param board The board.
+     * @param color The color of the king.
+     * @return The middlegame bonus of the shelter. */
+    static Value computeShelter(const Board& board, Color color);
+};
+
+/* @brief Evaluate the pawn structure of a position from scratch. The
+ *  shelters are left to be computed on demand.
+ * @param board The board to evaluate.
+ * @return The entry of the position, with the pawn key of the board. */
+Entry evaluate(const Board& board);
+
+/* Hash table of pawn structure evaluations, which belongs to a single search
+   thread and therefore needs no synchronisation. Since the pawns change in
+   few moves only, almost all probes during a search hit. A new entry always
+   replaces the old one. The initial entries have a zero key, which is the
+   key of a board without pawns, and a zero score, which is its evaluation. */
+class PawnTable {
+    public:
+    PawnTable() : m_entries(std::make_unique<Entry[]>(TABLE_SIZE)) {}
+
+    /* @brief Get the entry of the pawn structure of a board, which is
+     *  evaluated and stored if it is not in the table yet.
+     * @param board The board to look up.
+     * @return The entry, which stays valid until the next probe. */
+    Entry& probe(const Board& board);
+
+    /* @brief Reset the numbers of probes and hits. */
+    void resetStatistics() {
+        m_probes.store(0, std::memory_order_relaxed);
+        m_hits.store(0, std::memory_order_relaxed);
+    }
+
+    /* @brief Get the number of probes since the last reset, which may be
+     *  read by other threads while searching. */
+    uint64_t getProbes() const { return m_probes.load(std::memory_order_relaxed); }
+
+    /* @brief Get the number of probes that found their entry since the last
+     *  reset, which may be read by other threads while searching. */
+    uint64_t getHits() const { return m_hits.load(std::memory_order_relaxed); }
+
+    private:
+    std::unique_ptr<Entry[]> m_entries;
+
+    // written only by the owning thread, see Searcher::Worker
+    std::atomic<uint64_t> m_probes = 0;
+    std::atomic<uint64_t> m_hits = 0;
+};
+
+}   // namespace pawns
+
+#endif
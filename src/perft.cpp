@@ -0,0 +1,201 @@
+#include "perft.hpp"
+
+namespace perft {
+
+Cache::Cache(size_t size_mb) {
+    size_t max_buckets = std::max<size_t>(1, (size_mb << 20) / (BUCKET_SIZE * sizeof(Entry)));
+    m_n_buckets = std::bit_floor(max_buckets);
+    m_entries = std::make_unique<Entry[]>(m_n_buckets * BUCKET_SIZE);
+    clear();
+}
+
+bool Cache::probe(Key key, int depth, uint64_t& nodes) const {
+    const Entry* bucket = &m_entries[(key & (m_n_buckets - 1)) * BUCKET_SIZE];
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+        uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+        uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && int(data & 0xFF) == depth) {
+            nodes = data >> 8;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Cache::store(Key key, int depth, uint64_t nodes) {
+    Entry* bucket = &m_entries[(key & (m_n_buckets - 1)) * BUCKET_SIZE];
+    uint64_t data = (nodes << 8) | uint64_t(depth);
+
+    // keep the deeper subtree in the first slot and always replace the second
+    Entry* entry = &bucket[1];
+    if (depth >= int(bucket[0].data.load(std::memory_order_relaxed) & 0xFF)) {
+        entry = &bucket[0];
+    }
+    entry->check.store(key ^ data, std::memory_order_relaxed);
+    entry->data.store(data, std::memory_order_relaxed);
+}
+
+void Cache::clear() {
+    for (size_t i = 0; i < m_n_buckets * BUCKET_SIZE; ++i) {
+        m_entries[i].check.store(0ULL, std::memory_order_relaxed);
+        m_entries[i].data.store(0ULL, std::memory_order_relaxed);
+    }
+}
+
+size_t Cache::getNumberOfEntries() const {
+    return m_n_buckets * BUCKET_SIZE;
+}
+
+uint64_t countNodes(Board& board, int depth, bool bulk_counting, bool divide) {
+    // end search if base depth has been reached
+    if (depth == 0) {
+        return 1ULL;
+    }
+
+    // the number of leaf nodes at depth one is the number of legal moves
+    if (bulk_counting && depth == 1 && !divide) {
+        return countLegalMoves(board);
+    }
+
+    uint64_t nodes = 0;
+    for (const Move& move : MoveList<LEGAL>(board)) {
+        board.makeMove(move);
+        uint64_t child_nodes = countNodes(board, depth - 1, bulk_counting, false);
+        board.unmakeMove(move);
+
+        nodes += child_nodes;
+        if (divide) {
+            std::cout << move.toString() << ": " << child_nodes << std::endl;
+        }
+    }
+
+    return nodes;
+}
+
+uint64_t countNodes(Board& board, int depth, Cache& cache, CacheStatistics& statistics, bool bulk_counting) {
+    if (depth == 0) {
+        return 1ULL;
+    }
+    if (bulk_counting && depth == 1) {
+        return countLegalMoves(board);
+    }
+
+    // look up the subtree, which is not worth it for bulk counted leaves
+    Key key = board.getKey();
+    uint64_t nodes = 0;
+    statistics.probes++;
+    if (cache.probe(key, depth, nodes)) {
+        statistics.hits++;
+        return nodes;
+    }
+
+    for (const Move& move : MoveList<LEGAL>(board)) {
+        board.makeMove(move);
+        nodes += countNodes(board, depth - 1, cache, statistics, bulk_counting);
+        board.unmakeMove(move);
+    }
+
+    cache.store(key, depth, nodes);
+    return nodes;
+}
+
+/* A subtree to be counted by one of the worker threads, given by the moves
+   leading to it from the root. */
+struct Task {
+    size_t root_index;
+    Move moves[2];
+    int n_moves;
+    uint64_t nodes;
+};
+
+ParallelResult countNodesParallel(const Board& board, int depth, int n_threads,
+                                  bool bulk_counting, bool dynamic_split, Cache* cache) {
+    assert(depth > 0 && n_threads > 0);
+    auto start = std::chrono::steady_clock::now();
+
+    // split the tree at the root, or below each root move for a dynamic split
+    Board root_board = board;
+    MoveList<LEGAL> root_moves = MoveList<LEGAL>(root_board);
+    std::vector<Task> tasks;
+    for (size_t i = 0; i < root_moves.size(); ++i) {
+        Move root_move = root_moves[i];
+        if (dynamic_split && depth >= 3) {
+            root_board.makeMove(root_move);
+            for (const Move& move : MoveList<LEGAL>(root_board)) {
+                tasks.push_back(Task{i, {root_move, move}, 2, 0});
+            }
+            root_board.unmakeMove(root_move);
+        } else {
+            tasks.push_back(Task{i, {root_move, Move()}, 1, 0});
+        }
+    }
+
+    // lambda function to count the nodes of a single task
+    auto RunTask {[depth, bulk_counting, cache] (Board& worker_board, Task& task, ThreadStatistics& statistics) {
+        for (int i = 0; i < task.n_moves; ++i) {
+            worker_board.makeMove(task.moves[i]);
+        }
+        if (cache) {
+            task.nodes = countNodes(worker_board, depth - task.n_moves, *cache, statistics.cache, bulk_counting);
+        } else {
+            task.nodes = countNodes(worker_board, depth - task.n_moves, bulk_counting);
+        }
+        for (int i = task.n_moves - 1; i >= 0; --i) {
+            worker_board.unmakeMove(task.moves[i]);
+        }
+    }
+    };
+
+    // either take the next queued task or every n-th task of the static split
+    std::atomic<size_t> next_task = 0;
+    std::vector<ThreadStatistics> statistics(n_threads, ThreadStatistics{0, 0.0, CacheStatistics{0, 0}});
+    std::vector<std::thread> workers;
+    for (int t = 0; t < n_threads; ++t) {
+        workers.emplace_back([&, t] () {
+            // accumulate locally to avoid false sharing between the threads
+            auto thread_start = std::chrono::steady_clock::now();
+            ThreadStatistics thread_statistics = ThreadStatistics{0, 0.0, CacheStatistics{0, 0}};
+            Board worker_board = board;
+            if (dynamic_split) {
+                for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+                    RunTask(worker_board, tasks[i], thread_statistics);
+                    thread_statistics.nodes += tasks[i].nodes;
+                }
+            } else {
+                for (size_t i = t; i < tasks.size(); i += n_threads) {
+                    RunTask(worker_board, tasks[i], thread_statistics);
+                    thread_statistics.nodes += tasks[i].nodes;
+                }
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - thread_start;
+            thread_statistics.seconds = elapsed.count();
+            statistics[t] = thread_statistics;
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // merge the results in task order, which keeps the result deterministic
+    ParallelResult result;
+    result.nodes = 0;
+    for (size_t i = 0; i < root_moves.size(); ++i) {
+        result.divide.emplace_back(root_moves[i], 0);
+    }
+    for (const Task& task : tasks) {
+        result.divide[task.root_index].second += task.nodes;
+        result.nodes += task.nodes;
+    }
+    result.threads = statistics;
+    result.cache = CacheStatistics{0, 0};
+    for (const ThreadStatistics& thread : statistics) {
+        result.cache.probes += thread.cache.probes;
+        result.cache.hits += thread.cache.hits;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+
+    return result;
+}
+
+}   // namespace perft
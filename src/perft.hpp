@@ -0,0 +1,129 @@
+#ifndef PERFT_HPP
+#define PERFT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdint.h>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "board.hpp"
+#include "movegen.hpp"
+
+namespace perft {
+
+/* Number of lookups in the perft cache and how many of them were hits. */
+struct CacheStatistics {
+    uint64_t probes;
+    uint64_t hits;
+
+    double getHitRate() const { return probes ? double(hits) / double(probes) : 0.0; }
+};
+
+/* Lock-free hash table mapping positions and depths to the node counts of
+   their subtrees, which can be shared by several perft threads. Every entry
+   stores its key XOR-ed with its data, so an entry that was torn by two
+   threads writing at the same time fails verification and is treated as a
+   miss instead of returning a wrong count. Each bucket holds a slot that
+   prefers deeper subtrees and a slot that is always replaced. */
+class Cache {
+    private:
+    struct Entry {
+        std::atomic<uint64_t> check;    // key XOR data
+        std::atomic<uint64_t> data;     // node count (upper 56 bits) and depth (lower 8 bits)
+    };
+    static constexpr int BUCKET_SIZE = 2;
+
+    std::unique_ptr<Entry[]> m_entries;
+    size_t m_n_buckets;
+
+    public:
+    /* @brief Allocate a cache of at most the given size, rounded down to a
+     *  power of two number of buckets.
+     * @param size_mb The size of the cache in megabytes. */
+    explicit Cache(size_t size_mb);
+
+    /* @brief Look up the node count of a subtree.
+     * @param key The Zobrist key of the subtree's root position.
+     * @param depth The depth of the subtree.
+     * @param nodes Set to the cached node count on a hit.
+     * @return Whether a verified entry was found. */
+    bool probe(Key key, int depth, uint64_t& nodes) const;
+
+    /* @brief Store the node count of a subtree.
+     * @param key The Zobrist key of the subtree's root position.
+     * @param depth The depth of the subtree.
+     * @param nodes The node count of the subtree. */
+    void store(Key key, int depth, uint64_t nodes);
+
+    /* @brief Remove all entries. Must not be called while probing or storing. */
+    void clear();
+
+    /* @brief Get the number of entries the cache can hold. */
+    size_t getNumberOfEntries() const;
+};
+
+/* Node count, runtime and cache statistics of a single worker thread. */
+struct ThreadStatistics {
+    uint64_t nodes;
+    double seconds;
+    CacheStatistics cache;
+};
+
+/* Result of a parallel perft run. The node counts per root move are merged in
+   move generation order and do therefore not depend on the thread count. */
+struct ParallelResult {
+    uint64_t nodes;
+    double seconds;
+    std::vector<std::pair<Move, uint64_t>> divide;
+    std::vector<ThreadStatistics> threads;
+    CacheStatistics cache;
+};
+
+/* @brief Count all leaf nodes of the legal move tree of the given depth
+ *  (https://www.chessprogramming.org/Perft).
+ * @param board The board to start from, it is restored after counting.
+ * @param depth The depth of the move tree.
+ * @param bulk_counting Whether to count the legal moves at depth one instead
+ *  of playing each of them.
+ * @param divide Whether to print the node count of each root move.
+ * @return The number of leaf nodes. */
+uint64_t countNodes(Board& board, int depth, bool bulk_counting = true, bool divide = false);
+
+/* @brief Count all leaf nodes of the legal move tree of the given depth,
+ *  looking up and storing the node counts of subtrees in a cache.
+ * @param board The board to start from, it is restored after counting.
+ * @param depth The depth of the move tree.
+ * @param cache The cache to use, which may be shared with other threads.
+ * @param statistics The cache statistics to update.
+ * @param bulk_counting Whether to count the legal moves at depth one instead
+ *  of playing each of them.
+ * @return The number of leaf nodes. */
+uint64_t countNodes(Board& board, int depth, Cache& cache, CacheStatistics& statistics, bool bulk_counting = true);
+
+/* @brief Count all leaf nodes of the legal move tree of the given depth using
+ *  multiple threads, each of which works on its own copy of the board. With a
+ *  static split, the root moves are distributed evenly across the threads.
+ *  With a dynamic split, the subtrees of all moves at the second ply are
+ *  queued and taken by whichever thread becomes idle, which balances the load
+ *  for unbalanced trees.
+ * @param board The board to start from.
+ * @param depth The depth of the move tree.
+ * @param n_threads The number of worker threads.
+ * @param bulk_counting Whether to count the legal moves at depth one instead
+ *  of playing each of them.
+ * @param dynamic_split Whether to split the work dynamically.
+ * @param cache An optional cache shared by all threads.
+ * @return The total and per root move node counts and the thread statistics. */
+ParallelResult countNodesParallel(const Board& board, int depth, int n_threads,
+                                  bool bulk_counting = true, bool dynamic_split = true,
+                                  Cache* cache = nullptr);
+
+}   // namespace perft
+
+#endif
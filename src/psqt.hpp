@@ -0,0 +1,167 @@
+#ifndef PSQT_HPP
+#define PSQT_HPP
+
+#include <array>
+#include "types.hpp"
+
+namespace psqt {
+
+/* A pair of scores for the middlegame and the endgame, which the evaluation
+   interpolates between according to the game phase. */
+struct Score {
+    Value mg = 0;
+    Value eg = 0;
+
+    constexpr Score& operator+=(const Score& other) { mg += other.mg; eg += other.eg; return *this; }
+    constexpr Score& operator-=(const Score& other) { mg -= other.mg; eg -= other.eg; return *this; }
+    constexpr Score operator+(const Score& other) const { return Score{mg + other.mg, eg + other.eg}; }
+    constexpr Score operator-(const Score& other) const { return Score{mg - other.mg, eg - other.eg}; }
+    constexpr Score operator-() const { return Score{-mg, -eg}; }
+    constexpr Score operator*(int factor) const { return Score{mg * factor, eg * factor}; }
+    constexpr bool operator==(const Score& other) const = default;
+};
+
+// material values in both phases, pawns and rooks gain in the endgame
+constexpr Score MATERIAL[N_PIECE_TYPES] {
+    {0, 0},             // no piece
+    {100, 120},         // pawn
+    {320, 300},         // knight
+    {330, 320},         // bishop
+    {500, 530},         // rook
+    {900, 950},         // queen
+    {0, 0},             // king
+};
+
+// contribution of each piece type to the game phase, which starts at
+// MAX_PHASE with all pieces on the board and ends at zero without pieces
+constexpr int PHASE_WEIGHTS[N_PIECE_TYPES] = {0, 0, 1, 1, 2, 4, 0};
+constexpr int MAX_PHASE = 24;
+
+/* Piece-square tables from white's point of view, written as seen from
+   white's side of the board with the eighth rank on top. The knight, bishop,
+   rook and queen tables are the same in both phases, while the pawns are
+   pushed harder and the king is centralised in the endgame. */
+using Table = std::array<Value, N_SQUARES>;
+
+constexpr Table PAWN_MG = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  25,  25,  10,   5,   5,
+      0,   0,   0,  20,  20,   0,   0,   0,
+      5,  -5, -10,   0,   0, -10,  -5,   5,
+      5,  10,  10, -20, -20,  10,  10,   5,
+      0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+constexpr Table PAWN_EG = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     80,  80,  80,  80,  80,  80,  80,  80,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     30,  30,  30,  30,  30,  30,  30,  30,
+     15,  15,  15,  15,  15,  15,  15,  15,
+      5,   5,   5,   5,   5,   5,   5,   5,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+constexpr Table KNIGHT_MG = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50,
+};
+
+constexpr Table BISHOP_MG = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20,
+};
+
+constexpr Table ROOK_MG = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,  10,  10,  10,  10,  10,  10,   5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0,
+};
+
+constexpr Table QUEEN_MG = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+      0,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   5,   5,   5,   5,   5,   0, -10,
+    -10,   0,   5,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+};
+
+constexpr Table KING_MG = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20,
+};
+
+constexpr Table KING_EG = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50,
+};
+
+/* @brief Combine the material values and the piece-square tables into one
+ *  table of scores per piece and square, where black pieces count negative
+ *  and use the tables mirrored vertically.
+ * @return The table of scores, indexed by piece and square. */
+constexpr std::array<std::array<Score, N_SQUARES>, N_PIECE_IDS> computeScores() {
+    constexpr const Table* MG_TABLES[N_PIECE_TYPES] = {nullptr, &PAWN_MG, &KNIGHT_MG, &BISHOP_MG, &ROOK_MG, &QUEEN_MG, &KING_MG};
+    constexpr const Table* EG_TABLES[N_PIECE_TYPES] = {nullptr, &PAWN_EG, &KNIGHT_MG, &BISHOP_MG, &ROOK_MG, &QUEEN_MG, &KING_EG};
+    std::array<std::array<Score, N_SQUARES>, N_PIECE_IDS> scores{};
+    for (PieceType pieceType = PAWN; pieceType <= KING; pieceType++) {
+        for (Square square = 0; square < N_SQUARES; square++) {
+            // the tables list the eighth rank first, the squares start at a1
+            int index = square ^ 56;
+            Score score = Score{MATERIAL[pieceType].mg + (*MG_TABLES[pieceType])[index],
+                                MATERIAL[pieceType].eg + (*EG_TABLES[pieceType])[index]};
+            scores[make_piece(WHITE, pieceType)][square] = score;
+            scores[make_piece(BLACK, pieceType)][square ^ 56] = -score;
+        }
+    }
+    return scores;
+}
+
+constexpr std::array<std::array<Score, N_SQUARES>, N_PIECE_IDS> SCORES = computeScores();
+
+/* @brief Get the score of a piece on a square.
+ * @param piece The piece.
+ * @param square The square of the piece.
+ * @return The score from white's point of view. */
+constexpr Score getScore(Piece piece, Square square) {
+    return SCORES[piece][square];
+}
+
+}   // namespace psqt
+
+#endif
@@ -0,0 +1,605 @@
+#include "search.hpp"
+
+namespace search {
+
+/* @brief Convert a score to be stored in the transposition table, where mate
+ *  scores are relative to the stored position instead of the root.
+ * @param score The score relative to the root.
+ * @param ply The distance of the position from the root.
+ * @return The score relative to the position. */
+static Value scoreToTable(Value score, int ply) {
+    return (score >= VALUE_MATE_IN_MAX_PLY) ? score + ply
+         : (score <= -VALUE_MATE_IN_MAX_PLY) ? score - ply : score;
+}
+
+/* @brief Convert a score from the transposition table back to the root.
+ * @param score The score relative to the position.
+ * @param ply The distance of the position from the root.
+ * @return The score relative to the root. */
+static Value scoreFromTable(Value score, int ply) {
+    return (score >= VALUE_MATE_IN_MAX_PLY) ? score - ply
+         : (score <= -VALUE_MATE_IN_MAX_PLY) ? score + ply : score;
+}
+
+// the helper threads skip the depths of every other cycle of the given size,
+// starting at the given phase, so that they spread over several depths
+static constexpr int N_SKIP_PATTERNS = 20;
+static constexpr int SKIP_SIZE[N_SKIP_PATTERNS] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+static constexpr int SKIP_PHASE[N_SKIP_PATTERNS] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+// late move reductions by remaining depth and move number, which grow with
+// the logarithm of both
+static const auto REDUCTIONS = [] {
+    std::array<std::array<uint8_t, MAX_NUMBER_OF_MOVES>, MAX_PLY> reductions{};
+    for (int depth = 1; depth < MAX_PLY; depth++) {
+        for (int n_moves = 1; n_moves < MAX_NUMBER_OF_MOVES; n_moves++) {
+            reductions[depth][n_moves] = uint8_t(0.75 + std::log(depth) * std::log(n_moves) / 2.25);
+        }
+    }
+    return reductions;
+}();
+
+Searcher::Searcher(tt::TranspositionTable* table, int n_threads) : m_table(table) {
+    setThreads(n_threads);
+}
+
+void Searcher::setThreads(int n_threads) {
+    m_workers.clear();
+    for (int id = 0; id < std::max(n_threads, 1); id++) {
+        m_workers.push_back(std::make_unique<Worker>(*this, id));
+    }
+}
+
+void Searcher::clear() {
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        worker->clear();
+    }
+}
+
+Report Searcher::search(const Board& board, const Limits& limits, const ReportCallback& on_iteration) {
+    m_stop = false;
+    m_limits = limits;
+    m_start = std::chrono::steady_clock::now();
+    allocateTime(board.getSideToMove());
+
+    MoveList root_moves(board);
+    if (root_moves.size() == 0) {
+        return Report();
+    }
+
+    // the helpers are reset before any thread starts, so that the main thread
+    // does not count the nodes of a previous search
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        worker->reset(board);
+    }
+    std::vector<std::thread> helpers;
+    for (size_t id = 1; id < m_workers.size(); id++) {
+        helpers.emplace_back([this, id] { m_workers[id]->iterate(nullptr); });
+    }
+    m_workers[0]->iterate(on_iteration);
+
+    // an infinite search may only return once it is stopped, the helpers
+    // keep searching until then
+    while (limits.infinite && !m_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    m_stop = true;
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    // report the variation of the chosen move if it differs from the one
+    // last reported by the main thread
+    const Worker& best = selectBestWorker();
+    Report report = best.getReport();
+    report.nodes = getNodes();
+    report.qnodes = getQuiescenceNodes();
+    report.pawn_probes = getPawnProbes();
+    report.pawn_hits = getPawnHits();
+    report.seconds = getElapsedTime() / 1000.0;
+    if (&best != m_workers[0].get() && on_iteration) {
+        on_iteration(report);
+    }
+
+    // play any move if not even the first iteration could be completed
+    if (report.pv.empty()) {
+        report.pv.push_back(*root_moves.begin());
+    }
+    return report;
+}
+
+const Searcher::Worker& Searcher::selectBestWorker() const {
+    const Worker* best = m_workers[0].get();
+    Value min_score = VALUE_INFINITE;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        if (!worker->getReport().pv.empty()) {
+            min_score = std::min(min_score, worker->getReport().score);
+        }
+    }
+
+    // sum up the votes for every move
+    std::vector<std::pair<Move, int64_t>> votes;
+    auto getVotes = [&votes] (Move move) -> int64_t& {
+        for (auto& [voted_move, count] : votes) {
+            if (voted_move == move) {
+                return count;
+            }
+        }
+        return votes.emplace_back(move, 0).second;
+    };
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        const Report& report = worker->getReport();
+        if (!report.pv.empty()) {
+            getVotes(report.pv[0]) += int64_t(report.score - min_score + 14) * report.depth;
+        }
+    }
+
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        const Report& report = worker->getReport();
+        const Report& best_report = best->getReport();
+        if (report.pv.empty()) {
+            continue;
+        }
+        if (best_report.pv.empty()) {
+            best = worker.get();
+        } else if (isMateScore(report.score) || isMateScore(best_report.score)) {
+            // a faster mate, or a slower one against us, is always preferred
+            if (report.score > best_report.score) {
+                best = worker.get();
+            }
+        } else if (getVotes(report.pv[0]) > getVotes(best_report.pv[0])
+                   || (report.pv[0] == best_report.pv[0] && report.depth > best_report.depth)) {
+            best = worker.get();
+        }
+    }
+    return *best;
+}
+
+void Searcher::allocateTime(Color us) {
+    m_optimum_time = 0;
+    m_maximum_time = 0;
+    if (m_limits.move_time) {
+        m_optimum_time = m_limits.move_time;
+        m_maximum_time = m_limits.move_time;
+    } else if (m_limits.time[us]) {
+        // spread the remaining time over the moves until the next time
+        // control, or over a fixed number of moves in sudden death
+        int moves_to_go = m_limits.moves_to_go ? m_limits.moves_to_go : 30;
+        int64_t available = std::max<int64_t>(m_limits.time[us] - MOVE_OVERHEAD, 1);
+        int64_t share = std::min(available / moves_to_go + 3 * m_limits.increment[us] / 4, available);
+
+        // an iteration takes about as long as all previous ones together
+        m_optimum_time = std::max<int64_t>(share / 2, 1);
+        m_maximum_time = std::min(3 * share, available);
+    }
+}
+
+int64_t Searcher::getElapsedTime() const {
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+uint64_t Searcher::getNodes() const {
+    uint64_t nodes = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        nodes += worker->getNodes();
+    }
+    return nodes;
+}
+
+uint64_t Searcher::getQuiescenceNodes() const {
+    uint64_t nodes = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        nodes += worker->getQuiescenceNodes();
+    }
+    return nodes;
+}
+
+uint64_t Searcher::getPawnProbes() const {
+    uint64_t probes = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        probes += worker->getPawnTable().getProbes();
+    }
+    return probes;
+}
+
+uint64_t Searcher::getPawnHits() const {
+    uint64_t hits = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        hits += worker->getPawnTable().getHits();
+    }
+    return hits;
+}
+
+void Searcher::Worker::reset(const Board& board) {
+    m_board = board;
+    m_report = Report();
+    m_nodes.store(0, std::memory_order_relaxed);
+    m_qnodes.store(0, std::memory_order_relaxed);
+    m_next_check = 0;
+    m_pawn_table.resetStatistics();
+    m_previous_pv.clear();
+    m_heuristics.clearKillers();
+}
+
+void Searcher::Worker::iterate(const ReportCallback& on_iteration) {
+    const Limits& limits = m_searcher.m_limits;
+    int max_depth = limits.depth ? std::min(limits.depth, MAX_DEPTH) : MAX_DEPTH;
+    Value score = 0;
+    for (int depth = 1; depth <= max_depth; depth++) {
+        if (skipsDepth(depth)) {
+            continue;
+        }
+        score = searchAspirationWindow(depth, score);
+
+        // the result of an interrupted iteration is incomplete and discarded
+        if (m_searcher.m_stop) {
+            break;
+        }
+
+        m_report.depth = depth;
+        m_report.score = score;
+        m_report.nodes = getNodes();
+        m_report.qnodes = getQuiescenceNodes();
+        m_report.pawn_probes = m_pawn_table.getProbes();
+        m_report.pawn_hits = m_pawn_table.getHits();
+        m_report.seconds = m_searcher.getElapsedTime() / 1000.0;
+        m_report.pv.assign(m_pv[0], m_pv[0] + m_pv_length[0]);
+        m_previous_pv = m_report.pv;
+
+        // only the main thread reports and decides when to stop
+        if (m_id != 0) {
+            continue;
+        }
+        if (on_iteration) {
+            Report report = m_report;
+            report.nodes = m_searcher.getNodes();
+            report.qnodes = m_searcher.getQuiescenceNodes();
+            report.pawn_probes = m_searcher.getPawnProbes();
+            report.pawn_hits = m_searcher.getPawnHits();
+            on_iteration(report);
+        }
+
+        // a deeper search cannot find a faster mate
+        if (!limits.infinite && isMateScore(score) && VALUE_MATE - std::abs(score) <= depth) {
+            break;
+        }
+
+        // the next iteration would most likely not finish in time
+        if (m_searcher.m_optimum_time && m_searcher.getElapsedTime() >= m_searcher.m_optimum_time) {
+            break;
+        }
+    }
+}
+
+bool Searcher::Worker::skipsDepth(int depth) const {
+    if (m_id == 0) {
+        return false;
+    }
+    int pattern = (m_id - 1) % N_SKIP_PATTERNS;
+    return ((depth + SKIP_PHASE[pattern]) / SKIP_SIZE[pattern]) % 2 != 0;
+}
+
+void Searcher::Worker::checkLimits() {
+    if (m_id != 0 || getNodes() < m_next_check) {
+        return;
+    }
+    m_next_check = getNodes() + CHECK_INTERVAL;
+
+    // with the node limit in sight, the next check is brought forward to when
+    // the main thread has searched its share of the remaining nodes
+    const Limits& limits = m_searcher.m_limits;
+    if (limits.nodes) {
+        uint64_t nodes = m_searcher.getNodes();
+        if (nodes >= limits.nodes) {
+            m_searcher.m_stop = true;
+        }
+        uint64_t share = (limits.nodes - std::min(nodes, limits.nodes)) / m_searcher.getThreads();
+        m_next_check = std::min(m_next_check, getNodes() + std::max<uint64_t>(share, 1));
+    }
+    if (m_searcher.m_maximum_time && m_searcher.getElapsedTime() >= m_searcher.m_maximum_time) {
+        m_searcher.m_stop = true;
+    }
+}
+
+Value Searcher::Worker::searchAspirationWindow(int depth, Value previous) {
+    m_follow_pv = true;
+    if (depth < ASPIRATION_DEPTH) {
+        return searchPosition(depth, 0, -VALUE_INFINITE, VALUE_INFINITE);
+    }
+
+    // search with a narrow window around the previous score, which is widened
+    // towards the side where the score fell outside of it
+    Value delta = ASPIRATION_WINDOW;
+    Value alpha = std::max(previous - delta, -VALUE_INFINITE);
+    Value beta = std::min(previous + delta, VALUE_INFINITE);
+    while (true) {
+        Value score = searchPosition(depth, 0, alpha, beta);
+        if (m_searcher.m_stop) {
+            return score;
+        }
+
+        if (score <= alpha) {
+            alpha = std::max(score - delta, -VALUE_INFINITE);
+        } else if (score >= beta) {
+            beta = std::min(score + delta, VALUE_INFINITE);
+        } else {
+            return score;
+        }
+        delta *= 2;
+        m_follow_pv = true;
+    }
+}
+
+Value Searcher::Worker::searchPosition(int depth, int ply, Value alpha, Value beta) {
+    // at the horizon, the quiescence search resolves all captures, positions
+    // in check are extended instead
+    bool in_check = m_board.getCheckers();
+    if (depth <= 0 && !in_check) {
+        return searchQuiescence(ply, alpha, beta);
+    }
+
+    m_pv_length[ply] = 0;
+    m_nodes.store(m_nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    checkLimits();
+    if (m_searcher.m_stop) {
+        return 0;
+    }
+
+    // positions where neither side can mate are not searched any further
+    if (ply > 0 && (m_board.isDraw() || m_material_table.probe(m_board).is_draw)) {
+        return VALUE_DRAW;
+    }
+
+    // extend checks, so that the search never ends in a position in check
+    if (in_check) {
+        depth++;
+    }
+    if (ply >= MAX_PLY - 1) {
+        return eval::evaluate(m_board, m_pawn_table, m_material_table);
+    }
+
+    // outside of the principal variation, the stored result of an earlier
+    // search that was at least as deep can be used directly
+    bool is_pv_node = beta - alpha > 1;
+    tt::Entry entry;
+    bool tt_hit = m_searcher.m_table && m_searcher.m_table->probe(m_board.getKey(), entry);
+    if (tt_hit && !is_pv_node && entry.depth >= depth) {
+        Value score = scoreFromTable(entry.score, ply);
+        if (entry.bound == tt::BOUND_EXACT
+            || (entry.bound == tt::BOUND_LOWER && score >= beta)
+            || (entry.bound == tt::BOUND_UPPER && score <= alpha)) {
+            return score;
+        }
+    }
+
+    // the selective search only prunes nodes and moves outside of the
+    // principal variation and when not in check, where the static
+    // evaluation is a sensible estimate of the score
+    const Options& options = m_searcher.m_options;
+    Move previous = (ply > 0) ? m_played[ply - 1] : Move();
+    bool can_prune = !is_pv_node && !in_check;
+    Value static_eval = can_prune ? eval::evaluate(m_board, m_pawn_table, m_material_table) : -VALUE_INFINITE;
+
+    // reverse futility pruning, the evaluation is so far above beta that
+    // the opponent is unlikely to catch up in the remaining depth
+    if (can_prune && options.reverse_futility_pruning && depth <= REVERSE_FUTILITY_DEPTH
+        && std::abs(beta) < VALUE_MATE_IN_MAX_PLY && static_eval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+        return static_eval;
+    }
+
+    // null move pruning, the position still fails high if the side to move
+    // passes, which is only assumed with pieces left to avoid zugzwang, and
+    // not twice in a row
+    Color us = m_board.getSideToMove();
+    bool has_pieces = m_board.getPieceOccupancy(KNIGHT, us) | m_board.getPieceOccupancy(BISHOP, us)
+                    | m_board.getPieceOccupancy(ROOK, us) | m_board.getPieceOccupancy(QUEEN, us);
+    if (can_prune && options.null_move_pruning && depth >= NULL_MOVE_DEPTH && static_eval >= beta
+        && has_pieces && previous != Move() && std::abs(beta) < VALUE_MATE_IN_MAX_PLY) {
+        int reduction = 3 + depth / 4;
+        m_played[ply] = Move();
+        m_board.makeNullMove();
+        Value score = -searchPosition(depth - 1 - reduction, ply + 1, -beta, -beta + 1);
+        m_board.unmakeNullMove();
+        if (m_searcher.m_stop) {
+            return 0;
+        }
+        if (score >= beta) {
+            // mate scores of the null move search are not proven
+            return (score >= VALUE_MATE_IN_MAX_PLY) ? beta : score;
+        }
+    }
+
+    // search the move of the previous principal variation first, or else the
+    // best move stored in the transposition table
+    Move hash_move = tt_hit ? entry.move : Move();
+    if (m_follow_pv) {
+        m_follow_pv = ply < (int)m_previous_pv.size();
+        hash_move = m_follow_pv ? m_previous_pv[ply] : hash_move;
+    }
+    order::MovePicker picker(m_board, hash_move, m_heuristics, ply, previous);
+
+    // the helper threads search the root moves after the first one in a
+    // different order, so that they do not all start with the same subtrees
+    bool rotate_root = ply == 0 && m_id > 0;
+    int root_index = 0;
+    if (rotate_root) {
+        m_n_root_moves = 0;
+        for (Move move = picker.next(); move != Move(); move = picker.next()) {
+            m_root_moves[m_n_root_moves++] = move;
+        }
+        if (m_n_root_moves > 2) {
+            std::rotate(m_root_moves + 1, m_root_moves + 1 + m_id % (m_n_root_moves - 1), m_root_moves + m_n_root_moves);
+        }
+    }
+    auto next_move = [&] () {
+        return !rotate_root ? picker.next() : (root_index < m_n_root_moves) ? m_root_moves[root_index++] : Move();
+    };
+
+    Value original_alpha = alpha;
+    Move best_move = Move();
+    Value best_score = -VALUE_INFINITE;
+    Move quiets[MAX_NUMBER_OF_MOVES];
+    int n_quiets = 0;
+    int n_moves = 0;
+    for (Move move = next_move(); move != Move(); move = next_move()) {
+        bool is_quiet = !move.isCapture() && !move.isPromotion();
+        bool gives_check = m_board.givesCheck(move);
+
+        // once a move has saved the node from being mated, late quiet moves
+        // that do not give check may be skipped
+        if (can_prune && is_quiet && !gives_check && best_score > -VALUE_MATE_IN_MAX_PLY) {
+            // late move pruning, the moves are ordered well enough that the
+            // late ones at low depth rarely matter
+            if (options.late_move_pruning && depth <= LATE_MOVE_PRUNING_DEPTH && n_moves >= 3 + depth * depth) {
+                continue;
+            }
+            // futility pruning, the move would have to gain more than the
+            // margin to raise the score to alpha
+            if (options.futility_pruning && depth <= FUTILITY_DEPTH
+                && static_eval + FUTILITY_MARGIN * (depth + 1) <= alpha) {
+                continue;
+            }
+        }
+
+        m_played[ply] = move;
+        m_board.makeMove(move);
+
+        // the first move is searched with the full window, all others are
+        // expected to be worse and searched with a null window first, late
+        // quiet moves also with reduced depth
+        Value score;
+        if (n_moves++ == 0) {
+            score = -searchPosition(depth - 1, ply + 1, -beta, -alpha);
+            m_follow_pv = false;
+        } else {
+            int reduction = 0;
+            if (options.late_move_reductions && depth >= REDUCTION_DEPTH && n_moves > REDUCTION_MOVES
+                && is_quiet && !in_check && !gives_check) {
+                reduction = REDUCTIONS[std::min(depth, MAX_PLY - 1)][n_moves] - is_pv_node;
+                reduction = std::clamp(reduction, 0, depth - 2);
+            }
+            score = -searchPosition(depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+            if (score > alpha && reduction > 0 && !m_searcher.m_stop) {
+                score = -searchPosition(depth - 1, ply + 1, -alpha - 1, -alpha);
+            }
+            // an interrupted search returns no score that could justify a
+            // re-search
+            if (score > alpha && score < beta && !m_searcher.m_stop) {
+                score = -searchPosition(depth - 1, ply + 1, -beta, -alpha);
+            }
+        }
+
+        m_board.unmakeMove(move);
+        if (m_searcher.m_stop) {
+            return 0;
+        }
+
+        if (score > best_score) {
+            best_score = score;
+            if (score > alpha) {
+                alpha = score;
+                best_move = move;
+
+                // the move followed by the variation of its child
+                m_pv[ply][0] = move;
+                std::copy(m_pv[ply + 1], m_pv[ply + 1] + m_pv_length[ply + 1], m_pv[ply] + 1);
+                m_pv_length[ply] = m_pv_length[ply + 1] + 1;
+
+                if (alpha >= beta) {
+                    if (is_quiet) {
+                        m_heuristics.update(m_board, move, previous, ply, depth, quiets, n_quiets);
+                    }
+                    break;
+                }
+            }
+        }
+        if (is_quiet) {
+            quiets[n_quiets++] = move;
+        }
+    }
+
+    // the first move is never pruned, so no move has been searched only if
+    // there is no legal move
+    if (n_moves == 0) {
+        return in_check ? -VALUE_MATE + ply : VALUE_DRAW;
+    }
+
+    if (m_searcher.m_table) {
+        tt::Bound bound = (best_score >= beta) ? tt::BOUND_LOWER
+                        : (best_score > original_alpha) ? tt::BOUND_EXACT : tt::BOUND_UPPER;
+        m_searcher.m_table->store(m_board.getKey(), best_move, scoreToTable(best_score, ply), depth, bound);
+    }
+    return best_score;
+}
+
+Value Searcher::Worker::searchQuiescence(int ply, Value alpha, Value beta) {
+    m_pv_length[ply] = 0;
+    m_nodes.store(m_nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_qnodes.store(m_qnodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    checkLimits();
+    if (m_searcher.m_stop) {
+        return 0;
+    }
+
+    if (m_board.isDraw() || m_material_table.probe(m_board).is_draw) {
+        return VALUE_DRAW;
+    }
+    bool in_check = m_board.getCheckers();
+    if (ply >= MAX_PLY - 1) {
+        return in_check ? VALUE_DRAW : eval::evaluate(m_board, m_pawn_table, m_material_table);
+    }
+
+    // when not in check, the side to move is assumed to be able to reach at
+    // least the static evaluation with a quiet move
+    Value stand_pat = -VALUE_INFINITE;
+    Value best_score = -VALUE_INFINITE;
+    if (!in_check) {
+        stand_pat = eval::evaluate(m_board, m_pawn_table, m_material_table);
+        if (stand_pat >= beta) {
+            return stand_pat;
+        }
+        alpha = std::max(alpha, stand_pat);
+        best_score = stand_pat;
+    }
+
+    // all evasions when in check, otherwise the captures and promotions that
+    // do not lose material
+    order::MovePicker picker(m_board, m_heuristics);
+
+    for (Move move = picker.next(); move != Move(); move = picker.next()) {
+        // delta pruning, the capture cannot raise the score to alpha
+        if (!in_check && !move.isPromotion()) {
+            PieceType victim = move.isEnPassantCapture() ? static_cast<PieceType>(PAWN) : type_of(m_board.getPieceOnSquare(move.getTo()));
+            if (stand_pat + PIECE_VALUES[victim] + DELTA_MARGIN <= alpha) {
+                continue;
+            }
+        }
+
+        m_board.makeMove(move);
+        Value score = -searchQuiescence(ply + 1, -beta, -alpha);
+        m_board.unmakeMove(move);
+        if (m_searcher.m_stop) {
+            return 0;
+        }
+
+        if (score > best_score) {
+            best_score = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // in check, every evasion is searched, so there is none if no score has
+    // been found
+    if (in_check && best_score == -VALUE_INFINITE) {
+        return -VALUE_MATE + ply;
+    }
+    return best_score;
+}
+
+}   // namespace search
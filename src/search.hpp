@@ -0,0 +1,308 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include "board.hpp"
+#include "evaluation.hpp"
+#include "movegen.hpp"
+#include "moveorder.hpp"
+#include "material.hpp"
+#include "pawns.hpp"
+#include "transposition.hpp"
+
+namespace search {
+
+const int MAX_DEPTH = 64;               // maximum depth of the iterative deepening
+const int MAX_THREADS = 1024;
+const uint64_t CHECK_INTERVAL = 1024;   // nodes of the main thread between two checks of the limits
+
+const Value VALUE_DRAW = 0;
+const Value VALUE_MATE = 32000;         // score of being mated at the root
+const Value VALUE_INFINITE = 32001;
+const Value VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+const int ASPIRATION_DEPTH = 4;         // first depth to search with an aspiration window
+const Value ASPIRATION_WINDOW = 25;     // initial half width of the aspiration window
+const int64_t MOVE_OVERHEAD = 50;       // time reserved for communication per move in milliseconds
+const Value DELTA_MARGIN = 200;         // safety margin of the delta pruning in the quiescence search
+
+// parameters of the selective search
+const int NULL_MOVE_DEPTH = 3;              // minimum depth of the null move pruning
+const int REVERSE_FUTILITY_DEPTH = 6;       // maximum depth of the reverse futility pruning
+const Value REVERSE_FUTILITY_MARGIN = 80;   // margin of the reverse futility pruning per ply
+const int FUTILITY_DEPTH = 3;               // maximum depth of the futility pruning
+const Value FUTILITY_MARGIN = 100;          // margin of the futility pruning per ply, and at depth zero
+const int LATE_MOVE_PRUNING_DEPTH = 4;      // maximum depth of the late move pruning
+const int REDUCTION_DEPTH = 3;              // minimum depth of the late move reductions
+const int REDUCTION_MOVES = 3;              // number of moves that are never reduced
+
+/* Limits of a search as given by the UCI go command. A value of zero means
+   that the search is not limited in that regard. */
+struct Limits {
+    int64_t time[N_COLORS] = {0, 0};        // remaining time in milliseconds
+    int64_t increment[N_COLORS] = {0, 0};   // increment per move in milliseconds
+    int moves_to_go = 0;                    // moves until the next time control
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t move_time = 0;                  // exact time per move in milliseconds
+    bool infinite = false;                  // search until stopped
+};
+
+/* Switches of the selective search techniques, which are all enabled by
+   default and can be disabled one by one to measure their effect. */
+struct Options {
+    bool null_move_pruning = true;          // skip nodes where passing the turn still fails high
+    bool late_move_reductions = true;       // search late quiet moves with reduced depth first
+    bool reverse_futility_pruning = true;   // skip nodes whose evaluation is far above beta
+    bool futility_pruning = true;           // skip quiet moves that cannot raise the score to alpha
+    bool late_move_pruning = true;          // skip late quiet moves at low depths
+};
+
+/* Result of a completed iteration of the iterative deepening. */
+struct Report {
+    int depth = 0;
+    Value score = 0;
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0;                    // nodes of the quiescence search, included in the nodes
+    uint64_t pawn_probes = 0;               // lookups in the pawn hash tables
+    uint64_t pawn_hits = 0;                 // lookups that found their entry
+    double seconds = 0.0;
+    std::vector<Move> pv;
+};
+
+/* @brief Test whether a score announces a mate.
+ * @param score The score of a search.
+ * @return A boolean indicating whether either side mates. */
+inline bool isMateScore(Value score) {
+    return std::abs(score) >= VALUE_MATE_IN_MAX_PLY;
+}
+
+/* @brief Get the number of moves until mate for a mate score.
+ * @param score A mate score.
+ * @return The number of moves, negative if the side to move is mated. */
+inline int getMateDistance(Value score) {
+    return (score > 0) ? (VALUE_MATE - score + 1) / 2 : -(VALUE_MATE + score) / 2;
+}
+
+/* Iterative deepening principal variation search, run by one or more threads
+   in the manner of Lazy SMP. All threads search the same position on their
+   own copy of the board and communicate only through the shared
+   transposition table, with the helper threads skipping some of the depths
+   and searching the root moves in a different order so that they fill the
+   table with results the main thread has not found yet. The main thread
+   runs in the calling thread, decides when to stop and reports its
+   progress, and the best move is chosen by a vote among all threads. The
+   search can be stopped from any other thread. */
+class Searcher {
+    public:
+    using ReportCallback = std::function<void(const Report&)>;
+
+    /* @brief Set up a searcher.
+     * @param table The transposition table to use, which may be shared with
+     *  other searchers, or none.
+     * @param n_threads The number of threads to search with. */
+    explicit Searcher(tt::TranspositionTable* table = nullptr, int n_threads = 1);
+
+    /* @brief Search the given position within the given limits. An infinite
+     *  search only returns once it has been stopped.
+     * @param board The board to search.
+     * @param limits The limits of the search, where a node limit applies to
+     *  the nodes of all threads together.
+     * @param on_iteration Called with the result of each iteration completed
+     *  by the main thread.
+     * @return The result of the thread that won the vote, with the nodes of
+     *  all threads and an empty principal variation if there is no legal
+     *  move. */
+    Report search(const Board& board, const Limits& limits, const ReportCallback& on_iteration = nullptr);
+
+    /* @brief Stop a running search as soon as possible. */
+    void stop() { m_stop = true; }
+
+    /* @brief Test whether the search has been stopped, either by a call to
+     *  stop or because one of its limits has been reached.
+     * @return A boolean indicating whether the search has been stopped. */
+    bool isStopped() const { return m_stop; }
+
+    /* @brief Set the number of threads, must not be called while searching.
+     * @param n_threads The number of threads, at least one. */
+    void setThreads(int n_threads);
+
+    /* @brief Get the number of threads the searcher searches with. */
+    int getThreads() const { return int(m_workers.size()); }
+
+    /* @brief Set the selective search techniques to use, must not be called
+     *  while searching.
+     * @param options The switches of the techniques. */
+    void setOptions(const Options& options) { m_options = options; }
+
+    /* @brief Get the selective search techniques in use. */
+    const Options& getOptions() const { return m_options; }
+
+    /* @brief Reset what the threads learned about move ordering, at the
+     *  start of a new game. Must not be called while searching. */
+    void clear();
+
+    private:
+    /* State and search of a single thread, which only shares the stop signal,
+       the limits and the transposition table with the other threads. Since
+       every thread learns its own move ordering, the threads soon search the
+       moves in different orders. */
+    class Worker {
+        public:
+        /* @brief Set up a worker.
+         * @param searcher The searcher the worker belongs to.
+         * @param id The index of the thread, zero for the main thread. */
+        Worker(Searcher& searcher, int id) : m_searcher(searcher), m_id(id) {}
+
+        /* @brief Reset the move ordering tables, at the start of a new game. */
+        void clear() { m_heuristics.clear(); }
+
+        /* @brief Prepare the worker for a new search.
+         * @param board The position to search, copied into the worker. */
+        void reset(const Board& board);
+
+        /* @brief Run the iterative deepening until it is completed or stopped.
+         * @param on_iteration Called with the result of each completed
+         *  iteration, by the main thread only. */
+        void iterate(const ReportCallback& on_iteration);
+
+        /* @brief Get the result of the last completed iteration. */
+        const Report& getReport() const { return m_report; }
+
+        /* @brief Get the number of nodes searched so far, which may be read
+         *  by other threads while searching. */
+        uint64_t getNodes() const { return m_nodes.load(std::memory_order_relaxed); }
+
+        /* @brief Get the number of nodes searched by the quiescence search so
+         *  far, which may be read by other threads while searching. */
+        uint64_t getQuiescenceNodes() const { return m_qnodes.load(std::memory_order_relaxed); }
+
+        /* @brief Get the pawn hash table of the thread, whose statistics may
+         *  be read by other threads while searching. */
+        const pawns::PawnTable& getPawnTable() const { return m_pawn_table; }
+
+        private:
+        Searcher& m_searcher;
+        int m_id;
+        Board m_board;
+        Report m_report;
+
+        // written only by the owning thread, so a relaxed load and store are
+        // enough and avoid a locked increment at every node
+        std::atomic<uint64_t> m_nodes = 0;
+        std::atomic<uint64_t> m_qnodes = 0;
+
+        // number of own nodes at which the main thread checks the limits next
+        uint64_t m_next_check = 0;
+
+        // triangular table of principal variations, one for each ply
+        Move m_pv[MAX_PLY][MAX_PLY];
+        int m_pv_length[MAX_PLY];
+
+        // the principal variation of the previous iteration is searched first
+        std::vector<Move> m_previous_pv;
+        bool m_follow_pv = false;
+
+        // move ordering tables, and the moves played at each ply, which
+        // index the counter moves
+        order::Heuristics m_heuristics;
+        Move m_played[MAX_PLY];
+
+        // the root moves in the order in which a helper thread searches them
+        Move m_root_moves[MAX_NUMBER_OF_MOVES];
+        int m_n_root_moves = 0;
+
+        // cached pawn structure and material evaluations, kept across searches
+        pawns::PawnTable m_pawn_table;
+        material::MaterialTable m_material_table;
+
+        /* @brief Test whether a helper thread skips the given depth, so that
+         *  not all threads search the same depths at the same time.
+         * @param depth The depth of the iteration.
+         * @return A boolean indicating whether the depth is skipped. */
+        bool skipsDepth(int depth) const;
+
+        /* @brief Stop the search if the node or the time limit has been
+         *  reached, which only the main thread checks. Reading the clock and
+         *  the node counters of the other threads is expensive, so both are
+         *  only checked every CHECK_INTERVAL nodes of the main thread, and
+         *  more often when the node limit is close. */
+        void checkLimits();
+
+        /* @brief Search the root position with an aspiration window around
+         *  the score of the previous iteration.
+         * @param depth The depth of the iteration.
+         * @param previous The score of the previous iteration.
+         * @return The score of the root position. */
+        Value searchAspirationWindow(int depth, Value previous);
+
+        /* @brief Principal variation search of a position.
+         * @param depth The remaining depth.
+         * @param ply The distance from the root.
+         * @param alpha The lower bound of the search window.
+         * @param beta The upper bound of the search window.
+         * @return The score of the position from the side to move's perspective. */
+        Value searchPosition(int depth, int ply, Value alpha, Value beta);
+
+        /* @brief Quiescence search of a position at the end of the main
+         *  search, which only searches captures and promotions until the
+         *  position is quiet, or all evasions when in check. The side to move
+         *  may stand pat on the static evaluation instead of capturing.
+         *  Captures that cannot raise the score to alpha even if they win
+         *  their target for free, or that lose material according to the
+         *  static exchange evaluation, are skipped.
+         * @param ply The distance from the root.
+         * @param alpha The lower bound of the search window.
+         * @param beta The upper bound of the search window.
+         * @return The score of the position from the side to move's perspective. */
+        Value searchQuiescence(int ply, Value alpha, Value beta);
+    };
+
+    tt::TranspositionTable* m_table;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool> m_stop = false;
+    Options m_options;
+    Limits m_limits;
+    std::chrono::steady_clock::time_point m_start;
+    int64_t m_optimum_time = 0;             // time after which no new iteration is started
+    int64_t m_maximum_time = 0;             // time after which the search is stopped
+
+    /* @brief Allocate the time for the search from the limits.
+     * @param us The side to move. */
+    void allocateTime(Color us);
+
+    /* @brief Get the time since the start of the search.
+     * @return The elapsed time in milliseconds. */
+    int64_t getElapsedTime() const;
+
+    /* @brief Get the number of nodes searched by all threads so far. */
+    uint64_t getNodes() const;
+
+    /* @brief Get the number of quiescence nodes searched by all threads so far. */
+    uint64_t getQuiescenceNodes() const;
+
+    /* @brief Get the number of probes of the pawn hash tables of all threads
+     *  so far, and the number of those that hit. */
+    uint64_t getPawnProbes() const;
+    uint64_t getPawnHits() const;
+
+    /* @brief Choose the thread whose result is played. Every thread votes for
+     *  its best move with a weight growing with its depth and its score
+     *  relative to the other threads, and the deepest thread that voted for
+     *  the winning move is chosen, unless a thread has found a faster mate.
+     * @return The worker with the chosen result. */
+    const Worker& selectBestWorker() const;
+};
+
+}   // namespace search
+
+#endif
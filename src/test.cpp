@@ -3,8 +3,6 @@
 #include "types.hpp"
 
 int main(int argc, char* argv[]) {
-    
-    attacks::precalculate(true);
 
     //Bitboard bb = bb::getBitboard(Squares::A1);
     //bb::print(attacks::ROOK_MASK[Squares::B2]);
@@ -0,0 +1,99 @@
+#include "transposition.hpp"
+
+namespace tt {
+
+TranspositionTable::TranspositionTable(size_t size_mb, int n_threads) {
+    resize(size_mb, n_threads);
+}
+
+void TranspositionTable::resize(size_t size_mb, int n_threads) {
+    size_mb = std::clamp<size_t>(size_mb, 1, MAX_SIZE_MB);
+    size_t n_buckets = (size_mb << 20) / sizeof(Bucket);
+    m_buckets = std::make_unique_for_overwrite<Bucket[]>(n_buckets);
+    m_n_buckets = n_buckets;
+    clear(n_threads);
+}
+
+void TranspositionTable::clear(int n_threads) {
+    n_threads = std::max(n_threads, 1);
+    size_t chunk = (m_n_buckets + n_threads - 1) / n_threads;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t) {
+        size_t begin = std::min(m_n_buckets, t * chunk);
+        size_t end = std::min(m_n_buckets, begin + chunk);
+        threads.emplace_back([this, begin, end] {
+            std::fill(&m_buckets[0] + begin, &m_buckets[0] + end, Bucket{});
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    m_age = 0;
+}
+
+bool TranspositionTable::probe(Key key, Entry& entry) const {
+    Bucket& bucket = getBucket(key);
+    for (Slot& slot : bucket.slots) {
+        uint64_t check = std::atomic_ref<uint64_t>(slot.check).load(std::memory_order_relaxed);
+        uint64_t data = std::atomic_ref<uint64_t>(slot.data).load(std::memory_order_relaxed);
+        Bound bound = Bound((data >> BOUND_SHIFT) & 0b11);
+        if ((check ^ data) == key && bound != BOUND_NONE) {
+            entry.move = Move(uint16_t(data));
+            entry.score = int16_t(data >> SCORE_SHIFT);
+            entry.depth = uint8_t(data >> DEPTH_SHIFT);
+            entry.bound = bound;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(Key key, Move move, Value score, int depth, Bound bound) {
+    Bucket& bucket = getBucket(key);
+
+    // replace the entry of the same position if there is one, otherwise the
+    // entry with the lowest depth, where every search of age counts as much
+    // as eight plies of depth
+    Slot* replace = &bucket.slots[0];
+    int lowest_value = INT32_MAX;
+    for (Slot& slot : bucket.slots) {
+        uint64_t check = std::atomic_ref<uint64_t>(slot.check).load(std::memory_order_relaxed);
+        uint64_t data = std::atomic_ref<uint64_t>(slot.data).load(std::memory_order_relaxed);
+        if ((check ^ data) == key && ((data >> BOUND_SHIFT) & 0b11) != BOUND_NONE) {
+            if (move == Move()) {
+                move = Move(uint16_t(data));
+            }
+            replace = &slot;
+            break;
+        }
+        int age = (AGE_CYCLE + m_age - int(data >> AGE_SHIFT)) % AGE_CYCLE;
+        int value = int(uint8_t(data >> DEPTH_SHIFT)) - 8 * age;
+        if (value < lowest_value) {
+            lowest_value = value;
+            replace = &slot;
+        }
+    }
+
+    uint64_t data = uint64_t(move.getRaw())
+                  | (uint64_t(uint16_t(score)) << SCORE_SHIFT)
+                  | (uint64_t(std::clamp(depth, 0, 255)) << DEPTH_SHIFT)
+                  | (uint64_t(bound) << BOUND_SHIFT)
+                  | (uint64_t(m_age) << AGE_SHIFT);
+    std::atomic_ref<uint64_t>(replace->check).store(key ^ data, std::memory_order_relaxed);
+    std::atomic_ref<uint64_t>(replace->data).store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::getHashfull() const {
+    // sample the first thousand slots
+    size_t n_buckets = std::min<size_t>(m_n_buckets, 1000 / BUCKET_SIZE);
+    int count = 0;
+    for (size_t i = 0; i < n_buckets; ++i) {
+        for (Slot& slot : m_buckets[i].slots) {
+            uint64_t data = std::atomic_ref<uint64_t>(slot.data).load(std::memory_order_relaxed);
+            count += ((data >> BOUND_SHIFT) & 0b11) != BOUND_NONE && (data >> AGE_SHIFT) == m_age;
+        }
+    }
+    return count * 1000 / int(n_buckets * BUCKET_SIZE);
+}
+
+}   // namespace tt
@@ -0,0 +1,119 @@
+#ifndef TRANSPOSITION_HPP
+#define TRANSPOSITION_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include "move.hpp"
+#include "types.hpp"
+
+namespace tt {
+
+const size_t DEFAULT_SIZE_MB = 16;
+const size_t MAX_SIZE_MB = 1 << 15;
+
+/* Kind of bound that a stored score represents. */
+enum Bound : uint8_t {
+    BOUND_NONE,     // empty slot
+    BOUND_UPPER,    // the search failed low, the score is at most this
+    BOUND_LOWER,    // the search failed high, the score is at least this
+    BOUND_EXACT     // the score of a principal variation node
+};
+
+/* Decoded content of a transposition table entry. */
+struct Entry {
+    Move move;
+    Value score;
+    int depth;
+    Bound bound;
+};
+
+/* Lock-free hash table of search results, shared by all search threads. Each
+   bucket fills one cache line with four slots of two words, the packed data
+   and the key XOR-ed with the data. A slot that was torn by two threads
+   writing at the same time fails verification on probing and is treated as a
+   miss. The words are plain integers accessed through std::atomic_ref, which
+   allows allocating the table without touching it and clearing it in
+   parallel. Entries of earlier searches are replaced first, among those of
+   the same age the shallowest one is replaced. */
+class TranspositionTable {
+    private:
+    struct Slot {
+        uint64_t check;     // key XOR data
+        uint64_t data;      // move, score, depth, bound and age
+    };
+    static constexpr int BUCKET_SIZE = 4;
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+    static_assert(sizeof(Bucket) == 64, "A bucket must fill exactly one cache line.");
+
+    // layout of the data word
+    static constexpr int SCORE_SHIFT = 16;
+    static constexpr int DEPTH_SHIFT = 32;
+    static constexpr int BOUND_SHIFT = 40;
+    static constexpr int AGE_SHIFT = 42;
+    static constexpr int AGE_CYCLE = 64;
+
+    std::unique_ptr<Bucket[]> m_buckets;
+    size_t m_n_buckets = 0;
+    uint8_t m_age = 0;
+
+    Bucket& getBucket(Key key) const {
+        // map the key onto the buckets by the upper half of a 128-bit product,
+        // which works for any number of buckets
+        return m_buckets[size_t((unsigned __int128)key * m_n_buckets >> 64)];
+    }
+
+    public:
+    /* @brief Allocate a table of the given size, see resize.
+     * @param size_mb The size of the table in megabytes.
+     * @param n_threads The number of threads to clear the table with. */
+    explicit TranspositionTable(size_t size_mb = DEFAULT_SIZE_MB, int n_threads = 1);
+
+    /* @brief Reallocate the table, which removes all entries. Must not be
+     *  called while searching. If the allocation fails, std::bad_alloc is
+     *  thrown and the previous table is kept.
+     * @param size_mb The size of the table in megabytes.
+     * @param n_threads The number of threads to clear the table with. */
+    void resize(size_t size_mb, int n_threads = 1);
+
+    /* @brief Remove all entries, with every thread clearing an equal share of
+     *  the table. Must not be called while searching.
+     * @param n_threads The number of threads to clear the table with. */
+    void clear(int n_threads = 1);
+
+    /* @brief Advance the age of the table at the start of a new search, which
+     *  makes the entries of earlier searches the first to be replaced. */
+    void newSearch() { m_age = (m_age + 1) % AGE_CYCLE; }
+
+    /* @brief Look up the entry of a position.
+     * @param key The Zobrist key of the position.
+     * @param entry Set to the decoded entry on a hit.
+     * @return Whether a verified entry was found. */
+    bool probe(Key key, Entry& entry) const;
+
+    /* @brief Store the search result of a position. An existing entry of the
+     *  same position keeps its move if no new move is given.
+     * @param key The Zobrist key of the position.
+     * @param move The best move, may be empty.
+     * @param score The score, mate scores relative to the position.
+     * @param depth The remaining depth of the search.
+     * @param bound The kind of bound the score represents. */
+    void store(Key key, Move move, Value score, int depth, Bound bound);
+
+    /* @brief Estimate how full the table is from the entries of the current
+     *  search in a sample of the buckets.
+     * @return The occupancy in permille, as reported to UCI. */
+    int getHashfull() const;
+
+    /* @brief Get the number of entries the table can hold. */
+    size_t getNumberOfEntries() const { return m_n_buckets * BUCKET_SIZE; }
+};
+
+}   // namespace tt
+
+#endif
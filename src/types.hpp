@@ -11,9 +11,12 @@ using Direction = int8_t;
 using Color = uint8_t;
 using CastlingRight = uint8_t;
 using MoveFlag = uint8_t;
+using Key = uint64_t;
+using Value = int;
 
 const int MAX_NUMBER_OF_MOVES = 256;            // is actually 218
-const int GAME_STATE_HISTORY_LENGTH = 512;
+const int MAX_PLY = 128;                        // maximum distance from the root of a search
+const int GAME_STATE_HISTORY_LENGTH = 1024;     // maximum number of plies per game
 
 enum Squares {
     A1, B1, C1, D1, E1, F1, G1, H1,
@@ -74,6 +77,17 @@ constexpr char const* PIECE_TYPE_NAMES[] {
     "KING",
 };
 
+// material values in centipawns, the king is worth more than all other pieces
+constexpr Value PIECE_VALUES[N_PIECE_TYPES] {
+    0,          // no piece
+    100,        // pawn
+    320,        // knight
+    330,        // bishop
+    500,        // rook
+    900,        // queen
+    20000,      // king
+};
+
 const int PIECE_ID_OFFSET = 8;
 enum Pieces {
     NO_PIECE = 0,
@@ -91,6 +105,7 @@ enum Pieces {
     BLACK_KING,
 };
 const int N_PIECES = 13;
+const int N_PIECE_IDS = 2 * PIECE_ID_OFFSET;    // size of tables indexed by piece, with a gap between white and black
 
 constexpr char const* PIECE_SYMBOLS[] {
     "#",
@@ -110,13 +125,13 @@ constexpr char const* PIECE_SYMBOLS[] {
     "k",
 };
 
-const inline Piece make_piece(Color c, PieceType pt) {
+constexpr Piece make_piece(Color c, PieceType pt) {
     return Piece((c << 3) + pt);
 }
-const inline Color color_of(Piece pc) {
+constexpr Color color_of(Piece pc) {
     return Color(pc >> 3);
 }
-const inline PieceType type_of(Piece pc) {
+constexpr PieceType type_of(Piece pc) {
     return PieceType(pc & 7);
 }
 
@@ -133,7 +148,9 @@ enum Directions {
 const int N_DIRECTIONS = 8;
 
 enum Ranks {RANK_1, RANK_2, RANK_3, RANK_4, RANK_5, RANK_6, RANK_7, RANK_8};
+const int N_RANKS = 8;
 enum Files {FILE_A, FILE_B, FILE_C, FILE_D, FILE_E, FILE_F, FILE_G, FILE_H};
+const int N_FILES = 8;
 
 // rank definitions
 constexpr Bitboard RANK_1_BB = 0x00000000000000FFULL;
@@ -158,6 +175,7 @@ constexpr Bitboard FILE_A_BB = FILE_H_BB >> 7;
 // other relevant bitboard representations
 constexpr Bitboard EDGE_BB = 0xFF818181818181FF;
 constexpr Bitboard CORNER_BB = 0x8100000000000081;
+constexpr Bitboard DARK_SQUARES_BB = 0xAA55AA55AA55AA55;
 constexpr Bitboard WHITE_KINGSIDE_CASTLE_SQUARES = 0x0000000000000060;
 constexpr Bitboard WHITE_QUEENSIDE_CASTLE_SQUARES = 0x000000000000000E;
 constexpr Bitboard BLACK_KINGSIDE_CASTLE_SQUARES = 0x6000000000000000;
@@ -190,6 +208,20 @@ constexpr Bitboard CASTLING_SQUARES[N_CASTLING_RIGHTS] = {
 };
 constexpr Square CASTLING_KING_GOAL_SQUARE[N_CASTLING_RIGHTS] = { 0, G1, C1, 0, G8, 0, 0, 0, C8 };
 
+/* Castling rights that are withdrawn when a piece moves from or to the given
+   square, i.e. the rights depending on the king or a rook on its start square. */
+constexpr CastlingRight getAffectedCastlingRights(Square square) {
+    switch (square) {
+        case E1: return WHITE_CASTLING;
+        case H1: return WHITE_KINGSIDE_CASTLING;
+        case A1: return WHITE_QUEENSIDE_CASTLING;
+        case E8: return BLACK_CASTLING;
+        case H8: return BLACK_KINGSIDE_CASTLING;
+        case A8: return BLACK_QUEENSIDE_CASTLING;
+        default: return NO_CASTLING;
+    }
+}
+
 constexpr CastlingRights operator&(Color c, CastlingRights cr) {
     return CastlingRights((c == WHITE ? WHITE_CASTLING : BLACK_CASTLING) & (int)cr);
 }
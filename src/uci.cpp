@@ -13,33 +13,42 @@ void UniversalChessInterface::stop() {
 }
 
 void UniversalChessInterface::listen() {
+    std::string line;
     while(m_running) {
-        std::string line;
-        while(std::getline(std::cin, line)) {
-            Command command = Command(line);
-            std::vector<std::string> args = command.args();
+        // the end of the input is treated like a quit command
+        if (!std::getline(std::cin, line)) {
+            line = "quit";
+        }
+        Command command = Command(line);
 
-            std::cout << "Received command: " << std::endl;
-            std::cout << "   " << command.raw() << std::endl;
-            std::cout << "   args: [";
+        if (m_debug) {
+            std::vector<std::string> args = command.args();
+            std::string message = "info string received command: " + command.raw() + ", args: [";
             for (size_t i = 0; i < args.size(); ++i) {
-                std::cout << args[i];
-                if (i < args.size() - 1) {
-                    std::cout << ", ";
-                }
+                message += args[i] + ((i < args.size() - 1) ? ", " : "");
             }
-            std::cout << "]" << std::endl;
+            send(message + "]");
+        }
 
-            if (command.type() != UCI_INVALID_COMMAND) {
-                std::lock_guard<std::mutex> lock(m_queue_mutex);
-                m_command_queue.push(command);
-            } else {
-                std::cout << "Invalid command: " << command.raw() << std::endl;
-            }
+        if (command.type() != UCI_INVALID_COMMAND) {
+            std::lock_guard<std::mutex> lock(m_queue_mutex);
+            m_command_queue.push(command);
+        } else if (m_debug) {
+            send("info string invalid command: " + command.raw());
+        }
+
+        // stop listening once the GUI quits
+        if (command.type() == UCI_QUIT) {
+            m_running = false;
         }
     }
 }
 
+void UniversalChessInterface::send(const std::string& message) {
+    std::lock_guard<std::mutex> lock(m_output_mutex);
+    std::cout << message << std::endl;
+}
+
 Command UniversalChessInterface::popCommand() {
     std::unique_lock<std::mutex> lock(m_queue_mutex);
     if (m_command_queue.empty()) {
@@ -53,6 +62,10 @@ Command UniversalChessInterface::popCommand() {
 Command::Command(std::string in) {
     m_raw = in;
     std::vector<std::string> tokens = utils::tokenize(in, ' ');
+    if (tokens.empty()) {
+        m_type = UCI_INVALID_COMMAND;
+        return;
+    }
     m_args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
     
     std::string cmd = tokens.front();
@@ -72,6 +85,8 @@ Command::Command(std::string in) {
         m_type = UCI_QUIT;
     } else if (cmd == "debug") {
         m_type = UCI_DEBUG;
+    } else if (cmd == "setoption") {
+        m_type = UCI_SETOPTION;
     } else {
         m_type = UCI_INVALID_COMMAND;
     }
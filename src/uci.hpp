@@ -7,6 +7,7 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <iostream>
 #include "utils.hpp"
 
 enum CommandType {
@@ -18,6 +19,7 @@ enum CommandType {
     UCI_STOP,
     UCI_QUIT,
     UCI_DEBUG,
+    UCI_SETOPTION,
     UCI_INVALID_COMMAND
 };
 
@@ -42,9 +44,19 @@ public:
         std::lock_guard<std::mutex> lock(m_queue_mutex);
         return !m_command_queue.empty();
     }
+
+    /* @brief Send a message to the GUI, which may be called from any thread.
+     * @param message A single line without line break. */
+    void send(const std::string& message);
+
+    /* @brief Switch the debug output of received commands on or off.
+     * @param debug Whether to print debug output. */
+    void setDebug(bool debug) { m_debug = debug; }
 private:
     std::queue<Command> m_command_queue;
     std::mutex m_queue_mutex;
+    std::mutex m_output_mutex;
+    std::atomic<bool> m_debug{false};
 
     std::atomic<bool> m_running{true};
     std::thread m_thread;
@@ -0,0 +1,87 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <array>
+#include <stdint.h>
+#include "types.hpp"
+
+namespace zobrist {
+
+/* Note: The Zobrist keys are pseudo-random numbers generated at compile time
+ * from a fixed seed, which keeps position keys reproducible across runs. A
+ * position key is the XOR of the keys of all pieces on their squares, the
+ * side to move, the castling rights and the en passant file, such that it can
+ * be updated incrementally when a move is made. */
+
+struct Keys {
+    Key pieces[N_PIECE_IDS][N_SQUARES];
+    Key castling[N_CASTLING_RIGHTS];
+    Key en_passant[N_FILES];
+    Key side;
+};
+
+/* @brief Generate the next number of a SplitMix64 pseudo-random sequence.
+ * @param state The state of the generator, which is advanced.
+ * @return A pseudo-random 64-bit number. */
+constexpr uint64_t getRandomNumber(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* @brief Generate the full set of Zobrist keys.
+ * @return The keys for all position features. */
+constexpr Keys initializeKeys() {
+    Keys keys {};
+    uint64_t state = 0x5CA1AB1E2024ULL;
+    for (Piece piece = 0; piece < N_PIECE_IDS; piece++) {
+        for (Square square = 0; square < N_SQUARES; square++) {
+            // empty squares and unused piece ids must not alter the key
+            bool is_piece = type_of(piece) != NO_PIECE_TYPE && type_of(piece) <= KING;
+            keys.pieces[piece][square] = is_piece ? getRandomNumber(state) : 0ULL;
+        }
+    }
+    // the key of a combination of castling rights is the XOR of its individual rights
+    Key castling_keys[4] = {getRandomNumber(state), getRandomNumber(state), getRandomNumber(state), getRandomNumber(state)};
+    for (int cr = 0; cr < N_CASTLING_RIGHTS; cr++) {
+        for (int i = 0; i < 4; i++) {
+            keys.castling[cr] ^= (cr & (1 << i)) ? castling_keys[i] : 0ULL;
+        }
+    }
+    for (int file = 0; file < N_FILES; file++) {
+        keys.en_passant[file] = getRandomNumber(state);
+    }
+    keys.side = getRandomNumber(state);
+    return keys;
+}
+
+constexpr Keys KEYS = initializeKeys();
+
+inline constexpr Key getPieceKey(Piece piece, Square square) {
+    return KEYS.pieces[piece][square];
+}
+
+/* The material key of a position is the XOR of one key per piece, indexed by
+   how many pieces of that kind are already on the board. The piece-square keys
+   are reused for that purpose, since material keys are only ever compared with
+   each other. */
+inline constexpr Key getMaterialKey(Piece piece, int index) {
+    return KEYS.pieces[piece][index];
+}
+
+inline constexpr Key getCastlingKey(CastlingRight castling_rights) {
+    return KEYS.castling[castling_rights];
+}
+
+inline constexpr Key getEnPassantKey(int file) {
+    return KEYS.en_passant[file];
+}
+
+inline constexpr Key getSideKey() {
+    return KEYS.side;
+}
+
+}   // namespace zobrist
+
+#endif
@@ -1,19 +1,12 @@
 #include <gtest/gtest.h>
 #include "attacks.cpp"
 
-class AttacksTest : public ::testing::Test {
-protected:
-    void SetUp() override {
-        attacks::precalculate();
-    }
-};
-
-TEST_F(AttacksTest, GenerateMagicNumbers) {
+TEST(AttacksTest, EmbeddedMagicNumbers) {
     for (int is_bishop = 0; is_bishop < 2; is_bishop++) {
         for (int square = 0; square < N_SQUARES; square++) {
             // get attack mask and number of relevant bits
             Bitboard attack_mask = is_bishop ? attacks::bishop_magics[square].mask : attacks::rook_magics[square].mask;
-            int bits = is_bishop ? attacks::bishop_magics[square].mask_bits : attacks::rook_magics[square].mask_bits;
+            int bits = bb::count(attack_mask);
 
             // manually generate the attack mask for each blocker configuration
             for (int i = 0; i < (1 << bits); i++) {
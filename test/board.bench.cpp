@@ -0,0 +1,641 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "board.hpp"
+#include "evaluation.hpp"
+#include "mobility.hpp"
+#include "movegen.hpp"
+#include "nnue.hpp"
+#include "perft.hpp"
+#include "search.hpp"
+
+#if defined(USE_COPY_MAKE) && defined(USE_ATTACK_MAPS)
+#define BOARD_VARIANT "copy-make with attack maps"
+#elif defined(USE_COPY_MAKE)
+#define BOARD_VARIANT "copy-make"
+#elif defined(USE_ATTACK_MAPS)
+#define BOARD_VARIANT "undo with attack maps"
+#else
+#define BOARD_VARIANT "undo"
+#endif
+
+#ifdef USE_AVX2
+#define SIMD_VARIANT "AVX2"
+#else
+#define SIMD_VARIANT "scalar"
+#endif
+
+#define N_REPETITIONS 5
+#define N_MAKE_REPETITIONS 50
+#define N_MAKE_ITERATIONS 10000
+#define SEARCH_DEPTH 5
+#define SCALING_DEPTH 10
+#define SCALING_HASH_MB 64
+
+struct BenchmarkCase {
+    std::string fen;
+    int depth;
+};
+
+/* Standard perft positions at depths that take about a second each when
+   making every move. */
+std::vector<BenchmarkCase> BENCHMARK_CASES = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -", 4},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -", 6},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4}
+};
+
+/* @brief Run perft on all benchmark positions and print the best of several
+ *  repetitions per position.
+ * @param bulk_counting Whether to bulk count the leaves, otherwise every leaf
+ *  is reached by making a move, as a search would do. */
+static void runPerftBenchmark(bool bulk_counting) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::endl;
+    std::cout << "Board: " << BOARD_VARIANT << ", bulk counting: " << (bulk_counting ? "on" : "off") << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(6)  << "Case"
+              << std::setw(8)  << "Depth"
+              << std::setw(16) << "Nodes"
+              << std::setw(10) << "Time [s]"
+              << std::setw(16) << "Speed [nps]"
+              << std::endl;
+
+    uint64_t total_nodes = 0;
+    double total_seconds = 0.0;
+    for (size_t i = 0; i < BENCHMARK_CASES.size(); ++i) {
+        const BenchmarkCase& benchmark_case = BENCHMARK_CASES[i];
+        Board board = Board(benchmark_case.fen);
+        int depth = benchmark_case.depth;
+
+        uint64_t nodes = 0;
+        double seconds = 0.0;
+        for (int r = 0; r < N_REPETITIONS; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            nodes = perft::countNodes(board, depth, bulk_counting);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            seconds = (r == 0) ? elapsed.count() : std::min(seconds, elapsed.count());
+        }
+        total_nodes += nodes;
+        total_seconds += seconds;
+
+        std::cout << std::setw(6)  << i + 1
+                  << std::setw(8)  << depth
+                  << std::setw(16) << nodes
+                  << std::setw(10) << seconds
+                  << std::setw(16) << nodes / seconds
+                  << std::endl;
+    }
+    std::cout << std::setw(6)  << "Total"
+              << std::setw(8)  << ""
+              << std::setw(16) << total_nodes
+              << std::setw(10) << total_seconds
+              << std::setw(16) << total_nodes / total_seconds
+              << std::endl;
+    std::cout << std::endl;
+}
+
+TEST(BoardBenchmark, PerftBulkCounting) {
+    runPerftBenchmark(true);
+}
+
+TEST(BoardBenchmark, PerftMakeEveryMove) {
+    runPerftBenchmark(false);
+}
+
+/* @brief Make and unmake the given moves, whose side and flag are known at
+ *  compile time, as a caller that has sorted its moves by flag would do.
+ * @param board The board to make the moves on.
+ * @param moves The moves of the board with the given flag. */
+template <Color TColor, MoveFlag TFlag>
+static void makeAndUnmake(Board& board, const std::vector<Move>& moves) {
+    for (const Move& move : moves) {
+        board.makeMove<TColor, TFlag>(move);
+        board.unmakeMove<TColor, TFlag>(move);
+    }
+}
+
+template <Color TColor, MoveFlag... TFlags>
+static void makeAndUnmakeByFlag(Board& board, const std::vector<Move> (&moves)[16]) {
+    (makeAndUnmake<TColor, TFlags>(board, moves[TFlags]), ...);
+}
+
+template <Color TColor>
+static void makeAndUnmakeAllFlags(Board& board, const std::vector<Move> (&moves)[16]) {
+    makeAndUnmakeByFlag<TColor, QUIET, DOUBLE_PAWN_PUSH, KINGSIDE_CASTLE, QUEENSIDE_CASTLE, CAPTURE,
+        EN_PASSANT_CAPTURE, KNIGHT_PROMOTION, BISHOP_PROMOTION, ROOK_PROMOTION, QUEEN_PROMOTION,
+        KNIGHT_PROMOTION_CAPTURE, BISHOP_PROMOTION_CAPTURE, ROOK_PROMOTION_CAPTURE, QUEEN_PROMOTION_CAPTURE>(board, moves);
+}
+
+TEST(BoardBenchmark, MakeAndUnmakeMoves) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::endl;
+    std::cout << "Board: " << BOARD_VARIANT << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(6)  << "Case"
+              << std::setw(8)  << "Moves"
+              << std::setw(16) << "Runtime [M/s]"
+              << std::setw(16) << "Templated [M/s]"
+              << std::endl;
+
+    for (size_t i = 0; i < BENCHMARK_CASES.size(); ++i) {
+        Board board = Board(BENCHMARK_CASES[i].fen);
+        MoveList movelist(board);
+        std::vector<Move> moves_by_flag[16];
+        for (const Move& move : movelist) {
+            moves_by_flag[move.getFlag()].push_back(move);
+        }
+
+        // alternate between making the moves with a runtime dispatch on side
+        // and flag and with both known at compile time
+        double runtime_seconds = 0.0;
+        double templated_seconds = 0.0;
+        for (int r = 0; r < N_MAKE_REPETITIONS; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            for (int n = 0; n < N_MAKE_ITERATIONS; ++n) {
+                for (const Move& move : movelist) {
+                    board.makeMove(move);
+                    board.unmakeMove(move);
+                }
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            runtime_seconds = (r == 0) ? elapsed.count() : std::min(runtime_seconds, elapsed.count());
+
+            start = std::chrono::steady_clock::now();
+            for (int n = 0; n < N_MAKE_ITERATIONS; ++n) {
+                if (board.getSideToMove() == WHITE) {
+                    makeAndUnmakeAllFlags<WHITE>(board, moves_by_flag);
+                } else {
+                    makeAndUnmakeAllFlags<BLACK>(board, moves_by_flag);
+                }
+            }
+            elapsed = std::chrono::steady_clock::now() - start;
+            templated_seconds = (r == 0) ? elapsed.count() : std::min(templated_seconds, elapsed.count());
+        }
+
+        double n_moves = double(movelist.size()) * N_MAKE_ITERATIONS / 1e6;
+        std::cout << std::setw(6)  << i + 1
+                  << std::setw(8)  << movelist.size()
+                  << std::setw(16) << n_moves / runtime_seconds
+                  << std::setw(16) << n_moves / templated_seconds
+                  << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+TEST(BoardBenchmark, StaticExchangeEvaluation) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::endl;
+    std::cout << std::setw(6)  << "Case"
+              << std::setw(8)  << "Moves"
+              << std::setw(16) << "Speed [M/s]"
+              << std::setw(10) << "Winning"
+              << std::endl;
+
+    for (size_t i = 0; i < BENCHMARK_CASES.size(); ++i) {
+        Board board = Board(BENCHMARK_CASES[i].fen);
+        MoveList movelist(board);
+
+        // evaluate every legal move, quiet moves are tested for being safe
+        int n_winning = 0;
+        double seconds = 0.0;
+        for (int r = 0; r < N_MAKE_REPETITIONS; ++r) {
+            n_winning = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int n = 0; n < N_MAKE_ITERATIONS; ++n) {
+                for (const Move& move : movelist) {
+                    n_winning += board.see(move, 0);
+                }
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            seconds = (r == 0) ? elapsed.count() : std::min(seconds, elapsed.count());
+        }
+
+        double n_moves = double(movelist.size()) * N_MAKE_ITERATIONS / 1e6;
+        std::cout << std::setw(6)  << i + 1
+                  << std::setw(8)  << movelist.size()
+                  << std::setw(16) << n_moves / seconds
+                  << std::setw(10) << n_winning / N_MAKE_ITERATIONS
+                  << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/* @brief Evaluate a position like eval::evaluate, but with the material and
+ *  piece-square sums recomputed over all squares and the material and pawn
+ *  structure evaluated without the hash tables.
+ * @param board The board to evaluate.
+ * @return The score from the perspective of the side to move. */
+static Value evaluateFromScratch(const Board& board) {
+    material::Entry material = material::evaluate(board);
+    if (material.hasEvaluation()) {
+        return material.evaluate(board);
+    }
+    EvalAccumulator accumulator = board.computeAccumulator();
+    pawns::Entry entry = pawns::evaluate(board);
+    psqt::Score score = accumulator.score + material.imbalance + entry.score;
+    score.mg += pawns::Entry::computeShelter(board, WHITE) - pawns::Entry::computeShelter(board, BLACK);
+    score += mobility::evaluate(board, entry);
+    Color strong = (score.eg >= 0) ? WHITE : BLACK;
+    return eval::taper(board, score, material.phase, material.getScale(board, strong));
+}
+
+TEST(BoardBenchmark, Evaluation) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::endl;
+    std::cout << std::setw(6)  << "Case"
+              << std::setw(8)  << "Moves"
+              << std::setw(20) << "Incremental [M/s]"
+              << std::setw(20) << "Recompute [M/s]"
+              << std::endl;
+
+    for (size_t i = 0; i < BENCHMARK_CASES.size(); ++i) {
+        Board board = Board(BENCHMARK_CASES[i].fen);
+        MoveList movelist(board);
+
+        // evaluate the positions after every legal move, once from the sums
+        // kept by the board and the hash tables and once recomputing
+        // everything from scratch
+        std::vector<Board> boards;
+        for (const Move& move : movelist) {
+            boards.push_back(board);
+            boards.back().makeMove(move);
+        }
+        pawns::PawnTable pawn_table;
+        material::MaterialTable material_table;
+        double seconds[2] = {0.0, 0.0};
+        Value checksum[2] = {0, 0};
+        for (int r = 0; r < N_MAKE_REPETITIONS; ++r) {
+            for (int variant = 0; variant < 2; ++variant) {
+                checksum[variant] = 0;
+                auto start = std::chrono::steady_clock::now();
+                for (int n = 0; n < N_MAKE_ITERATIONS; ++n) {
+                    for (const Board& position : boards) {
+                        if (variant == 0) {
+                            checksum[variant] += eval::evaluate(position, pawn_table, material_table);
+                        } else {
+                            checksum[variant] += evaluateFromScratch(position);
+                        }
+                    }
+                }
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                seconds[variant] = (r == 0) ? elapsed.count() : std::min(seconds[variant], elapsed.count());
+            }
+        }
+        EXPECT_EQ(checksum[0], checksum[1]);
+
+        double n_evaluations = double(boards.size()) * N_MAKE_ITERATIONS / 1e6;
+        std::cout << std::setw(6)  << i + 1
+                  << std::setw(8)  << movelist.size()
+                  << std::setw(20) << n_evaluations / seconds[0]
+                  << std::setw(20) << n_evaluations / seconds[1]
+                  << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/* The first positions of the Bratko-Kopec test, a fixed set of middlegame
+   and endgame positions with many pieces of all kinds. */
+std::vector<std::string> MOBILITY_EPDS = {
+    "1k1r4/pp1b1R2/3q2pp/4p3/2B5/4Q3/PPP2B2/2K5 b - - bm Qd1+; id \"BK.01\";",
+    "3r1k2/4npp1/1ppr3p/p6P/P2PPPP1/1NR5/5K2/2R5 w - - bm d5; id \"BK.02\";",
+    "2q1rr1k/3bbnnp/p2p1pp1/2pPp3/PpP1P1P1/1P2BNNP/2BQ1PRK/7R b - - bm f5; id \"BK.03\";",
+    "rnbqkb1r/p3pppp/1p6/2ppP3/3N4/2P5/PPP1QPPP/R1B1KB1R w KQkq - bm e6; id \"BK.04\";",
+    "r1b2rk1/2q1b1pp/p2ppn2/1p6/3QP3/1BN1B3/PPP3PP/R4RK1 w - - bm Nd5 a4; id \"BK.05\";",
+    "2r3k1/pppR1pp1/4p3/4P1P1/5P2/1P4K1/P1P5/8 w - - bm g6; id \"BK.06\";",
+    "1nk1r1r1/pp2n1pp/4p3/q2pPp1N/b1pP1P2/B1P2R2/2P1B1PP/R2Q2K1 w - - bm Nf6; id \"BK.07\";",
+    "4b3/p3kp2/6p1/3pP2p/2pP1P2/4K1P1/P3N2P/8 w - - bm f5; id \"BK.08\";",
+    "2kr1bnr/pbpq4/2n1pp2/3p3p/3P1P1B/2N2N1Q/PPP3PP/2KR1B1R w - - bm f5; id \"BK.09\";",
+    "3rr1k1/pp3pp1/1qn2np1/8/3p4/PP1R1P2/2P1NQPP/R1B3K1 b - - bm Ne5; id \"BK.10\";",
+    "2r1nrk1/p2q1ppp/bp1p4/n1pPp3/P1P1P3/2PBB1N1/4QPPP/R4RK1 w - - bm f4; id \"BK.11\";",
+    "r3r1k1/ppqb1ppp/8/4p1NQ/8/2P5/PP3PPP/R3R1K1 b - - bm Bf5; id \"BK.12\";"
+};
+
+/* @brief Create a board from an EPD record, which has no move counters.
+ * @param epd The record.
+ * @return The board. */
+static Board boardFromEPD(const std::string& epd) {
+    std::istringstream stream(epd);
+    std::string fields[4];
+    for (std::string& field : fields) {
+        stream >> field;
+    }
+    return Board(fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3] + " 0 1");
+}
+
+/* @brief Count the attacks of all pieces of one type and color one by one,
+ *  like an evaluation without the collecting stage would do.
+ * @return The sum of the counts. */
+template <PieceType TPieceType>
+static uint64_t countPieces(const Board& board, Color color, Bitboard area, Bitboard king_zone, Bitboard targets, Bitboard& threats) {
+    uint64_t sum = 0;
+    int attackers = 0;
+    Bitboard pieces = board.getPieceOccupancy(TPieceType, color);
+    while (pieces) {
+        Square square = bb::popLSB(pieces);
+        Bitboard attacks = attacks::getPieceAttacks<TPieceType>(square, board.getTotalOccupancy());
+        int king_attacks = bb::count(attacks & king_zone);
+        sum += bb::count(attacks & area) + king_attacks * mobility::KING_ATTACK_WEIGHTS[TPieceType];
+        attackers += king_attacks != 0;
+        threats |= attacks & targets;
+    }
+    return sum + attackers;
+}
+
+/* @brief Count the attacks of all pieces with a scalar loop per piece.
+ * @return A checksum of the counts. */
+static uint64_t countPerPiece(const Board& board, const pawns::Entry& pawns) {
+    uint64_t checksum = 0;
+    for (Color color : {WHITE, BLACK}) {
+        Color them = !color;
+        Square king = board.getKingSquare(color);
+        Square their_king = board.getKingSquare(them);
+        Bitboard area = ~(board.getPieceOccupancy(PAWN, color) | bb::getBitboard(king) | pawns.attacks[them]);
+        Bitboard king_zone = attacks::getPieceAttacks<KING>(their_king, 0ULL) | bb::getBitboard(their_king);
+        Bitboard queens = board.getPieceOccupancy(QUEEN, them);
+        Bitboard rooks = board.getPieceOccupancy(ROOK, them);
+        Bitboard threats = 0ULL;
+        checksum += countPieces<KNIGHT>(board, color, area, king_zone, rooks | queens, threats);
+        checksum += countPieces<BISHOP>(board, color, area, king_zone, rooks | queens, threats);
+        checksum += countPieces<ROOK>(board, color, area, king_zone, queens, threats);
+        checksum += countPieces<QUEEN>(board, color, area, king_zone, 0ULL, threats);
+        checksum += bb::count(threats);
+    }
+    return checksum;
+}
+
+/* @brief Count the attacks of all pieces with the collecting stage of the
+ *  evaluation and the given counting function.
+ * @return A checksum of the counts. */
+template <void (*TCount)(const mobility::AttackTable&, mobility::AttackCounts&)>
+static uint64_t countCollected(const Board& board, const pawns::Entry& pawns) {
+    mobility::AttackTable table;
+    mobility::AttackCounts counts;
+    mobility::collect(board, pawns, table);
+    TCount(table, counts);
+    uint64_t checksum = 0;
+    for (Color color : {WHITE, BLACK}) {
+        for (int index = 0; index < table.n_pieces[color]; index++) {
+            checksum += counts.mobility[color][index];
+        }
+        checksum += counts.king_attack_weights[color] + counts.king_attackers[color] + bb::count(counts.threats[color]);
+    }
+    return checksum;
+}
+
+TEST(BoardBenchmark, Mobility) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::endl;
+    std::cout << "Kernels: " << SIMD_VARIANT << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(6)  << "Case"
+              << std::setw(20) << "Per piece [M/s]"
+              << std::setw(20) << "Scalar [M/s]"
+              << std::setw(20) << "Collected [M/s]"
+              << std::setw(20) << "Eval piece [M/s]"
+              << std::setw(20) << "Eval coll. [M/s]"
+              << std::endl;
+
+    for (size_t i = 0; i < MOBILITY_EPDS.size(); ++i) {
+        Board board = boardFromEPD(MOBILITY_EPDS[i]);
+        pawns::Entry pawns = pawns::evaluate(board);
+
+        // count the attacks with a loop over the pieces, and after collecting
+        // them with the scalar fallback and with the configured counting, and
+        // score them with both variants of the evaluation
+        double seconds[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        uint64_t checksum[5] = {0, 0, 0, 0, 0};
+        psqt::Score scores[2];
+        for (int r = 0; r < N_MAKE_REPETITIONS; ++r) {
+            for (int variant = 0; variant < 5; ++variant) {
+                checksum[variant] = 0;
+                auto start = std::chrono::steady_clock::now();
+                for (int n = 0; n < N_MAKE_ITERATIONS; ++n) {
+                    if (variant == 0) {
+                        checksum[variant] += countPerPiece(board, pawns);
+                    } else if (variant == 1) {
+                        checksum[variant] += countCollected<mobility::countScalar>(board, pawns);
+                    } else if (variant == 2) {
+                        checksum[variant] += countCollected<mobility::count>(board, pawns);
+                    } else if (variant == 3) {
+                        scores[0] += mobility::evaluatePerPiece(board, pawns);
+                    } else {
+                        scores[1] += mobility::evaluateCollected(board, pawns);
+                    }
+                }
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                seconds[variant] = (r == 0) ? elapsed.count() : std::min(seconds[variant], elapsed.count());
+            }
+        }
+        EXPECT_EQ(checksum[0], checksum[1]);
+        EXPECT_EQ(checksum[0], checksum[2]);
+        EXPECT_EQ(scores[0], scores[1]);
+
+        double n_positions = double(N_MAKE_ITERATIONS) / 1e6;
+        std::cout << std::setw(6)  << i + 1
+                  << std::setw(20) << n_positions / seconds[0]
+                  << std::setw(20) << n_positions / seconds[1]
+                  << std::setw(20) << n_positions / seconds[2]
+                  << std::setw(20) << n_positions / seconds[3]
+                  << std::setw(20) << n_positions / seconds[4]
+                  << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/* @brief Load a network with random parameters, whose evaluation takes as
+ *  long as that of a trained one. */
+static void loadRandomNetwork() {
+    std::mt19937 generator(1);
+    std::stringstream stream;
+    auto write = [&] <typename T> (const T* data, size_t count) {
+        stream.write(reinterpret_cast<const char*>(data), std::streamsize(sizeof(T) * count));
+    };
+    auto writeRandom = [&] <typename T> (size_t count, int low, int high) {
+        std::uniform_int_distribution<int> distribution(low, high);
+        std::vector<T> values(count);
+        std::generate(values.begin(), values.end(), [&] { return T(distribution(generator)); });
+        write(values.data(), count);
+    };
+    uint32_t header[] = {nnue::VERSION, 0, 0, 0};
+    write(header, 4);
+    writeRandom.operator()<int16_t>(nnue::N_HIDDEN, 0, 64);
+    writeRandom.operator()<int16_t>(size_t(nnue::N_FEATURES) * nnue::N_HIDDEN, -16, 16);
+    write(header + 3, 1);
+    writeRandom.operator()<int32_t>(nnue::N_LAYER_1, -2000, 2000);
+    writeRandom.operator()<int8_t>(nnue::N_LAYER_1 * nnue::N_INPUTS, -8, 8);
+    writeRandom.operator()<int32_t>(nnue::N_LAYER_2, -2000, 2000);
+    writeRandom.operator()<int8_t>(nnue::N_LAYER_2 * nnue::N_LAYER_1, -64, 64);
+    writeRandom.operator()<int32_t>(1, -2000, 2000);
+    writeRandom.operator()<int8_t>(nnue::N_LAYER_2, -64, 64);
+    nnue::load(stream);
+}
+
+TEST(BoardBenchmark, NetworkEvaluation) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::endl;
+    std::cout << "Kernels: " << SIMD_VARIANT << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(6)  << "Case"
+              << std::setw(8)  << "Moves"
+              << std::setw(18) << "Classical [M/s]"
+              << std::setw(18) << "Network [M/s]"
+              << std::setw(18) << "Scalar [M/s]"
+              << std::setw(18) << "Scratch [M/s]"
+              << std::endl;
+
+    for (size_t i = 0; i < BENCHMARK_CASES.size(); ++i) {
+        // make every legal move and evaluate the position with the classical
+        // evaluation, with the network updated incrementally and propagated
+        // with the configured and the scalar kernels, and with the network
+        // computed from scratch
+        nnue::unload();
+        Board board = Board(BENCHMARK_CASES[i].fen);
+        MoveList movelist(board);
+        pawns::PawnTable pawn_table;
+        material::MaterialTable material_table;
+        double seconds[4] = {0.0, 0.0, 0.0, 0.0};
+        Value checksum[4] = {0, 0, 0, 0};
+        for (int variant = 0; variant < 4; ++variant) {
+            if (variant == 1) {
+                loadRandomNetwork();
+                board = Board(BENCHMARK_CASES[i].fen);
+            }
+            for (int r = 0; r < N_REPETITIONS; ++r) {
+                checksum[variant] = 0;
+                auto start = std::chrono::steady_clock::now();
+                for (int n = 0; n < N_MAKE_ITERATIONS; ++n) {
+                    for (const Move& move : movelist) {
+                        board.makeMove(move);
+                        if (variant == 0) {
+                            checksum[variant] += eval::evaluate(board, pawn_table, material_table);
+                        } else if (variant == 1) {
+                            checksum[variant] += nnue::evaluate(board);
+                        } else if (variant == 2) {
+                            checksum[variant] += nnue::propagateScalar(board.getNetworkAccumulator(), board.getSideToMove());
+                        } else {
+                            checksum[variant] += nnue::propagate(nnue::computeAccumulator(board), board.getSideToMove());
+                        }
+                        board.unmakeMove(move);
+                    }
+                }
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                seconds[variant] = (r == 0) ? elapsed.count() : std::min(seconds[variant], elapsed.count());
+            }
+        }
+        EXPECT_EQ(checksum[1], checksum[2]);
+        EXPECT_EQ(checksum[1], checksum[3]);
+
+        double n_evaluations = double(movelist.size()) * N_MAKE_ITERATIONS / 1e6;
+        std::cout << std::setw(6)  << i + 1
+                  << std::setw(8)  << movelist.size()
+                  << std::setw(18) << n_evaluations / seconds[0]
+                  << std::setw(18) << n_evaluations / seconds[1]
+                  << std::setw(18) << n_evaluations / seconds[2]
+                  << std::setw(18) << n_evaluations / seconds[3]
+                  << std::endl;
+    }
+    nnue::unload();
+    std::cout << std::endl;
+}
+
+TEST(BoardBenchmark, Search) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::endl;
+    std::cout << "Board: " << BOARD_VARIANT << ", search depth: " << SEARCH_DEPTH << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(6)  << "Case"
+              << std::setw(16) << "Nodes"
+              << std::setw(10) << "Time [s]"
+              << std::setw(16) << "Speed [nps]"
+              << std::setw(10) << "Best"
+              << std::setw(18) << "Pawn hits [%]"
+              << std::endl;
+
+    search::Limits limits;
+    limits.depth = SEARCH_DEPTH;
+    search::Searcher searcher;
+    uint64_t total_nodes = 0;
+    double total_seconds = 0.0;
+    for (size_t i = 0; i < BENCHMARK_CASES.size(); ++i) {
+        Board board = Board(BENCHMARK_CASES[i].fen);
+        search::Report report = searcher.search(board, limits);
+        total_nodes += report.nodes;
+        total_seconds += report.seconds;
+
+        std::cout << std::setw(6)  << i + 1
+                  << std::setw(16) << report.nodes
+                  << std::setw(10) << report.seconds
+                  << std::setw(16) << report.nodes / report.seconds
+                  << std::setw(10) << report.pv[0].toString()
+                  << std::setw(18) << 100.0 * report.pawn_hits / std::max<uint64_t>(report.pawn_probes, 1)
+                  << std::endl;
+    }
+    std::cout << std::setw(6)  << "Total"
+              << std::setw(16) << total_nodes
+              << std::setw(10) << total_seconds
+              << std::setw(16) << total_nodes / total_seconds
+              << std::endl;
+    std::cout << std::endl;
+}
+
+TEST(BoardBenchmark, SearchScaling) {
+    // thread counts up to the hardware concurrency, but at least two so that
+    // the overhead of a helper thread shows even on a single core
+    int max_threads = std::max<int>(std::thread::hardware_concurrency(), 2);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::endl;
+    std::cout << "Board: " << BOARD_VARIANT << ", search depth: " << SCALING_DEPTH
+              << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(8)  << "Threads"
+              << std::setw(16) << "Nodes"
+              << std::setw(10) << "Time [s]"
+              << std::setw(16) << "Speed [nps]"
+              << std::setw(14) << "nps speedup"
+              << std::setw(14) << "ttd speedup"
+              << std::endl;
+
+    // every thread count searches all cases to the same depth from an empty
+    // table, so that the summed time is the time to depth
+    search::Limits limits;
+    limits.depth = SCALING_DEPTH;
+    double base_nps = 0.0;
+    double base_seconds = 0.0;
+    for (int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        tt::TranspositionTable table(SCALING_HASH_MB, n_threads);
+        search::Searcher searcher(&table, n_threads);
+        uint64_t total_nodes = 0;
+        double total_seconds = 0.0;
+        for (const BenchmarkCase& benchmark_case : BENCHMARK_CASES) {
+            table.clear(n_threads);
+            searcher.clear();
+            search::Report report = searcher.search(Board(benchmark_case.fen), limits);
+            total_nodes += report.nodes;
+            total_seconds += report.seconds;
+        }
+        double nps = total_nodes / total_seconds;
+        if (n_threads == 1) {
+            base_nps = nps;
+            base_seconds = total_seconds;
+        }
+
+        std::cout << std::setw(8)  << n_threads
+                  << std::setw(16) << total_nodes
+                  << std::setw(10) << total_seconds
+                  << std::setw(16) << nps
+                  << std::setw(14) << nps / base_nps
+                  << std::setw(14) << base_seconds / total_seconds
+                  << std::endl;
+    }
+    std::cout << std::endl;
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "movegen.hpp"
 #include "board.cpp"
 
@@ -63,3 +64,362 @@ TEST_F(BoardTest, MakeAndUnmakeMoves) {
         // TODO: add test cases for castling rights
     }
 }
+
+TEST_F(BoardTest, CastlingRights) {
+    // a rook promoted on a corner square of the opponent keeps the own rights when moving away
+    board = Board("r3k2r/Pppp1ppp/1b3nbN/nPP5/BB2P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1");
+    board.makeMove(Move(B2, A1, ROOK_PROMOTION_CAPTURE));
+    board.makeMove(Move(H2, H3, QUIET));
+    board.makeMove(Move(A1, B1, QUIET));
+    EXPECT_EQ(board.getCastlingRights(), BLACK_CASTLING);
+
+    // capturing a rook on its start square withdraws the opponent's right
+    board = Board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    board.makeMove(Move(A1, A8, CAPTURE));
+    EXPECT_EQ(board.getCastlingRights(), WHITE_KINGSIDE_CASTLING | BLACK_KINGSIDE_CASTLING);
+    board.unmakeMove(Move(A1, A8, CAPTURE));
+    EXPECT_EQ(board.getCastlingRights(), ANY_CASTLING);
+
+    // moving the king withdraws both own rights
+    board.makeMove(Move(E1, F1, QUIET));
+    EXPECT_EQ(board.getCastlingRights(), BLACK_CASTLING);
+}
+
+TEST_F(BoardTest, ZobristKeys) {
+    Key initial_key = board.computeKey();
+
+    // transpositions yield the same key, the side to move changes it
+    board.makeMove(Move(G1, F3, QUIET));
+    EXPECT_NE(board.computeKey(), initial_key);
+    board.makeMove(Move(G8, F6, QUIET));
+    board.makeMove(Move(F3, G1, QUIET));
+    board.makeMove(Move(F6, G8, QUIET));
+    EXPECT_EQ(board.computeKey(), initial_key);
+    EXPECT_NE(Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1").computeKey(), initial_key);
+
+    // castling rights and en passant targets are part of the key
+    EXPECT_NE(Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w Kkq - 0 1").computeKey(), initial_key);
+    EXPECT_NE(Board("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1").computeKey(),
+              Board("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1").computeKey());
+}
+
+/* Positions with checks, pins, discovered checks and en passant captures that
+   expose the king. */
+const std::vector<std::string> MOVEGEN_TEST_FENS = {
+    INITIAL_FEN,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1",
+    "8/8/8/K2pP2r/8/8/8/7k w - d6 0 1",
+    "4k3/8/8/8/1b6/8/3P4/4K3 w - - 0 1",
+    "4k3/8/8/8/8/5n2/8/3RK2q w - - 0 1",
+    "3k4/8/8/1B6/8/3N4/3R4/4K2R w K - 0 1",
+    "5k2/1P6/8/8/8/2B5/3P4/R3K3 w Q - 0 1",
+    "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1",
+};
+
+/* Encode a move list into a sorted vector for comparison. */
+template <GenerationType TType>
+static std::vector<uint16_t> getSortedMoves(const Board& board) {
+    std::vector<uint16_t> moves;
+    for (const Move& move : MoveList<TType>(board)) {
+        moves.push_back(move.getFlag() << FLAG_SHIFT | move.getTo() << TO_SHIFT | move.getFrom());
+    }
+    std::sort(moves.begin(), moves.end());
+    return moves;
+}
+
+TEST_F(BoardTest, LegalMoveGeneration) {
+    for (const std::string& fen : MOVEGEN_TEST_FENS) {
+        Board board = Board(fen);
+
+        // the legal moves must match the pseudo-legal moves that do not leave
+        // the own king in check
+        std::vector<uint16_t> expected;
+        for (const Move& move : MoveList<PSEUDO_LEGAL>(board)) {
+            board.makeMove(move);
+            bool in_check = board.isInCheck(!board.getSideToMove());
+            board.unmakeMove(move);
+
+            EXPECT_EQ(board.isLegal(move), !in_check) << "isLegal failed for move " << move.toString() << " in FEN: " << fen;
+            if (!in_check) {
+                expected.push_back(move.getFlag() << FLAG_SHIFT | move.getTo() << TO_SHIFT | move.getFrom());
+            }
+        }
+
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(getSortedMoves<LEGAL>(board), expected) << "Legal move generation failed for FEN: " << fen;
+    }
+}
+
+TEST_F(BoardTest, PseudoLegality) {
+    for (const std::string& fen : MOVEGEN_TEST_FENS) {
+        Board board = Board(fen);
+
+        // every generated move is pseudo-legal, and of all possible moves
+        // exactly the legal ones pass both tests
+        for (const Move& move : MoveList<PSEUDO_LEGAL>(board)) {
+            EXPECT_TRUE(board.isPseudoLegal(move)) << move.toString() << " in FEN: " << fen;
+        }
+        std::vector<uint16_t> accepted;
+        for (uint32_t raw = 0; raw < (1 << 16); raw++) {
+            Move move = Move(uint16_t(raw));
+            if (board.isPseudoLegal(move) && board.isLegal(move)) {
+                accepted.push_back(raw);
+            }
+        }
+        EXPECT_EQ(getSortedMoves<LEGAL>(board), accepted) << "Pseudo-legality failed for FEN: " << fen;
+    }
+}
+
+TEST_F(BoardTest, IncrementalZobristKeys) {
+    for (const std::string& fen : MOVEGEN_TEST_FENS) {
+        board = Board(fen);
+        Key key = board.getKey();
+        Key pawn_key = board.getPawnKey();
+        Key material_key = board.getMaterialKey();
+
+        // the keys are updated after each move and restored after unmaking it
+        for (const Move& move : MoveList(board)) {
+            board.makeMove(move);
+            EXPECT_EQ(board.getKey(), board.computeKey()) << fen << " " << move.toString();
+            EXPECT_EQ(board.getPawnKey(), board.computePawnKey()) << fen << " " << move.toString();
+            EXPECT_EQ(board.getMaterialKey(), board.computeMaterialKey()) << fen << " " << move.toString();
+            board.unmakeMove(move);
+            EXPECT_EQ(board.getKey(), key);
+            EXPECT_EQ(board.getPawnKey(), pawn_key);
+            EXPECT_EQ(board.getMaterialKey(), material_key);
+        }
+    }
+}
+
+TEST_F(BoardTest, IncrementalEvaluation) {
+    // the initial position is balanced
+    board = Board();
+    EXPECT_EQ(board.getAccumulator().score, psqt::Score());
+
+    for (const std::string& fen : MOVEGEN_TEST_FENS) {
+        board = Board(fen);
+        EvalAccumulator accumulator = board.getAccumulator();
+        EXPECT_EQ(accumulator, board.computeAccumulator()) << fen;
+
+        // the sums are updated after each move and restored after unmaking it
+        for (const Move& move : MoveList(board)) {
+            board.makeMove(move);
+            EXPECT_EQ(board.getAccumulator(), board.computeAccumulator()) << fen << " " << move.toString();
+            board.unmakeMove(move);
+            EXPECT_EQ(board.getAccumulator(), accumulator) << fen << " " << move.toString();
+        }
+    }
+
+    // the sums of a black piece mirror those of the same white piece
+    EXPECT_EQ(psqt::getScore(BLACK_KNIGHT, F6), -psqt::getScore(WHITE_KNIGHT, F3));
+    EXPECT_EQ(psqt::getScore(BLACK_KING, G8), -psqt::getScore(WHITE_KING, G1));
+}
+
+/* @brief Compare the attack information of a board against a computation from
+ *  scratch, which is only a real test when the board maintains attack maps. */
+static void expectConsistentAttacks(const Board& board, const std::string& context) {
+    Bitboard attacked[N_COLORS] = {0ULL, 0ULL};
+    for (Square square = 0; square < N_SQUARES; square++) {
+        Bitboard attackers = board.getAttackersTo(square, board.getTotalOccupancy());
+        EXPECT_EQ(board.getAttackersTo(square), attackers) << context << " " << square;
+        for (Color color : {WHITE, BLACK}) {
+            if (attackers & board.getColorOccupancy(color)) {
+                bb::set(attacked[color], square);
+            }
+            EXPECT_EQ(board.isAttackedBy(square, color), bool(attackers & board.getColorOccupancy(color)));
+        }
+    }
+    EXPECT_EQ(board.getAttackedSquares(WHITE), attacked[WHITE]) << context;
+    EXPECT_EQ(board.getAttackedSquares(BLACK), attacked[BLACK]) << context;
+}
+
+TEST_F(BoardTest, AttackMaps) {
+    for (const std::string& fen : MOVEGEN_TEST_FENS) {
+        board = Board(fen);
+        expectConsistentAttacks(board, fen);
+
+        // the attacks are updated after each move and restored after unmaking it
+        for (const Move& move : MoveList(board)) {
+            board.makeMove(move);
+            expectConsistentAttacks(board, fen + " " + move.toString());
+            board.unmakeMove(move);
+            expectConsistentAttacks(board, fen);
+        }
+    }
+}
+
+TEST_F(BoardTest, CheckInformation) {
+    for (const std::string& fen : MOVEGEN_TEST_FENS) {
+        board = Board(fen);
+        Color us = board.getSideToMove();
+        Bitboard checkers = board.getCheckers();
+        EXPECT_EQ(checkers, board.getAttackersTo(board.getKingSquare(us), board.getTotalOccupancy())
+                            & board.getColorOccupancy(!us)) << fen;
+
+        // every pinner attacks its king through exactly one pinned piece
+        Bitboard pinners = board.getPinners(!us);
+        while (pinners) {
+            Square pinner = bb::popLSB(pinners);
+            Bitboard between = attacks::getSquaresBetween(board.getKingSquare(us), pinner) & board.getTotalOccupancy();
+            EXPECT_EQ(between & board.getKingBlockers(us) & board.getColorOccupancy(us), between) << fen;
+        }
+
+        // a move gives check if the opponent is in check after making it, the
+        // check information of the position is restored after unmaking it
+        for (const Move& move : MoveList(board)) {
+            bool gives_check = board.givesCheck(move);
+            board.makeMove(move);
+            EXPECT_EQ(gives_check, board.isInCheck(board.getSideToMove())) << fen << " " << move.toString();
+            EXPECT_EQ(bool(board.getCheckers()), board.isAttackedBy(board.getKingSquare(!us), us));
+            board.unmakeMove(move);
+            EXPECT_EQ(board.getCheckers(), checkers);
+        }
+    }
+}
+
+TEST_F(BoardTest, DrawDetection) {
+    // the knights return to their squares, which repeats the initial position
+    board = Board();
+    std::vector<Move> moves = {Move(G1, F3, QUIET), Move(G8, F6, QUIET), Move(F3, G1, QUIET), Move(F6, G8, QUIET)};
+    for (const Move& move : moves) {
+        EXPECT_FALSE(board.isDraw());
+        board.makeMove(move);
+    }
+    EXPECT_TRUE(board.isDraw());
+
+    // a pawn move resets the halfmove clock, the fifty move rule applies at 100
+    EXPECT_FALSE(Board("4k3/8/8/8/8/8/4P3/4K3 w - - 99 80").isDraw());
+    EXPECT_TRUE(Board("4k3/8/8/8/8/8/4P3/4K3 w - - 100 80").isDraw());
+    board = Board("4k3/8/8/8/8/8/4P3/4K3 w - - 99 80");
+    board.makeMove(Move(E2, E3, QUIET));
+    EXPECT_FALSE(board.isDraw());
+}
+
+TEST_F(BoardTest, DiscardHistory) {
+    // only the moves since the last pawn move are kept, repetitions among
+    // them are still detected
+    board = Board();
+    std::vector<Move> moves = {Move(E2, E3, QUIET), Move(G8, F6, QUIET), Move(G1, F3, QUIET),
+                               Move(F6, G8, QUIET), Move(F3, G1, QUIET)};
+    for (const Move& move : moves) {
+        board.makeMove(move);
+        board.discardHistory();
+    }
+    EXPECT_EQ(board.getPly(), 4);
+    EXPECT_TRUE(board.isDraw());
+}
+
+TEST_F(BoardTest, NullMove) {
+    // passing the turn clears the en passant target and is fully undone
+    board = Board("rnbqkbnr/ppp1pppp/8/8/3pP3/5N2/PPPP1PPP/RNBQKB1R b KQkq e3 0 3");
+    Key key = board.getKey();
+    board.makeNullMove();
+    EXPECT_EQ(board.getSideToMove(), WHITE);
+    EXPECT_EQ(board.getCurrentEnPassantTarget(), 0ULL);
+    EXPECT_EQ(board.getKey(), board.computeKey());
+    EXPECT_NE(board.getKey(), key);
+    EXPECT_EQ(board.getCheckSquares(KNIGHT), attacks::getPieceAttacks<KNIGHT>(E8, 0ULL));
+    board.unmakeNullMove();
+    EXPECT_EQ(board.getSideToMove(), BLACK);
+    EXPECT_EQ(board.getKey(), key);
+    EXPECT_NE(board.getCurrentEnPassantTarget(), 0ULL);
+
+    // a position reached again by passing the turn is no repetition
+    board = Board();
+    board.makeMove(Move(G1, F3, QUIET));
+    board.makeNullMove();
+    board.makeMove(Move(F3, G1, QUIET));
+    board.makeNullMove();
+    EXPECT_EQ(board.getKey(), Board().getKey());
+    EXPECT_FALSE(board.isDraw());
+}
+
+struct ExchangeTestCase {
+    std::string fen;
+    Move move;
+    Value value;    // exact material outcome of the exchange
+};
+
+const Value P = PIECE_VALUES[PAWN];
+const Value N = PIECE_VALUES[KNIGHT];
+const Value B = PIECE_VALUES[BISHOP];
+const Value R = PIECE_VALUES[ROOK];
+const Value Q = PIECE_VALUES[QUEEN];
+
+const std::vector<ExchangeTestCase> EXCHANGE_TEST_CASES = {
+    // undefended pawn
+    {"1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", Move(E1, E5, CAPTURE), P},
+    // long exchange with x-rays of both queens, stopped by black
+    {"1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", Move(D3, E5, CAPTURE), P - N},
+    // pawn trade
+    {"4R3/2r3p1/5bk1/1p1r3p/p2PR1P1/P1BK1P2/1P6/8 b - - 0 1", Move(H5, G4, CAPTURE), 0},
+    // bishop for knight, the queen behind the bishop recaptures on f3
+    {"4r1k1/5pp1/nbp4p/1p2p2q/1P2P1b1/1BP2N1P/1B2QPPK/3R4 b - - 0 1", Move(G4, F3, CAPTURE), N - B},
+    // the queen recaptures along the rank
+    {"2r1r1k1/pp1bppbp/3p1np1/q3P3/2P2P2/1P2B3/P1N1B1PP/2RQ1RK1 b - - 0 1", Move(D6, E5, CAPTURE), P},
+    // quiet move into an exchange that evens out
+    {"7r/5qpk/p1Qp1b1p/3r3n/BB3p2/5p2/P1P2P2/4RK1R w - - 0 1", Move(E1, E8, QUIET), 0},
+    // quiet move losing the rook, the bishop's x-ray is blocked
+    {"6rr/6pk/p1Qp1b1p/2n5/1B3p2/5p2/P1P2P2/4RK1R w - - 0 1", Move(E1, E8, QUIET), -R},
+    // black stops after winning the bishop instead of losing the rook
+    {"8/pp6/2pkp3/4bp2/2R3b1/2P5/PP4B1/1K6 w - - 0 1", Move(G2, C6, CAPTURE), P - B},
+    // promotion on an undefended square
+    {"6k1/1P6/8/8/8/8/8/6K1 w - - 0 1", Move(B7, B8, QUEEN_PROMOTION), Q - P},
+    // en passant capture
+    {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", Move(E5, D6, EN_PASSANT_CAPTURE), P},
+    // the king may not recapture a defended pawn
+    {"8/8/3k4/3p4/4P3/8/8/3RK3 w - - 0 1", Move(E4, D5, CAPTURE), P},
+    // the pinned knight may not recapture
+    {"4k3/8/4n3/8/3p4/2P5/8/4R1K1 w - - 0 1", Move(C3, D4, CAPTURE), P},
+    // castling is neutral
+    {"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", Move(E1, G1, KINGSIDE_CASTLE), 0},
+};
+
+TEST_F(BoardTest, StaticExchangeEvaluation) {
+    for (const ExchangeTestCase& test_case : EXCHANGE_TEST_CASES) {
+        board = Board(test_case.fen);
+        EXPECT_TRUE(board.see(test_case.move, test_case.value)) << test_case.fen;
+        EXPECT_FALSE(board.see(test_case.move, test_case.value + 1)) << test_case.fen;
+    }
+}
+
+TEST_F(BoardTest, StagedMoveGeneration) {
+    for (const std::string& fen : MOVEGEN_TEST_FENS) {
+        Board board = Board(fen);
+        std::vector<uint16_t> legal = getSortedMoves<LEGAL>(board);
+
+        // captures and quiets together must yield all legal moves
+        std::vector<uint16_t> staged = getSortedMoves<CAPTURES>(board);
+        std::vector<uint16_t> quiets = getSortedMoves<QUIETS>(board);
+        staged.insert(staged.end(), quiets.begin(), quiets.end());
+        std::sort(staged.begin(), staged.end());
+        EXPECT_EQ(staged, legal) << "Captures and quiets do not match legal moves for FEN: " << fen;
+
+        // evasions must yield all legal moves when in check
+        if (board.isInCheck(board.getSideToMove())) {
+            EXPECT_EQ(getSortedMoves<EVASIONS>(board), legal) << "Evasions do not match legal moves for FEN: " << fen;
+        }
+
+        // quiet checks must be exactly the quiet moves that give check
+        std::vector<uint16_t> expected_checks;
+        for (const Move& move : MoveList<QUIETS>(board)) {
+            board.makeMove(move);
+            if (board.isInCheck(board.getSideToMove())) {
+                expected_checks.push_back(move.getFlag() << FLAG_SHIFT | move.getTo() << TO_SHIFT | move.getFrom());
+            }
+            board.unmakeMove(move);
+        }
+        std::sort(expected_checks.begin(), expected_checks.end());
+        EXPECT_EQ(getSortedMoves<QUIET_CHECKS>(board), expected_checks) << "Quiet checks failed for FEN: " << fen;
+    }
+}
+
+TEST_F(BoardTest, CountLegalMoves) {
+    for (const std::string& fen : MOVEGEN_TEST_FENS) {
+        Board board = Board(fen);
+        EXPECT_EQ(countLegalMoves(board), MoveList<LEGAL>(board).size()) << "Move count failed for FEN: " << fen;
+    }
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "endgame.hpp"
+#include "evaluation.hpp"
+#include "material.hpp"
+#include "search.hpp"
+
+TEST(EndgameTest, MaterialKey) {
+    EXPECT_EQ(endgame::getMaterialKey("KBNK", WHITE), Board("8/8/8/4k3/8/8/8/KBN5 w - - 0 1").getMaterialKey());
+    EXPECT_EQ(endgame::getMaterialKey("KBNK", BLACK), Board("kbn5/8/8/8/8/8/3K4/8 w - - 0 1").getMaterialKey());
+    EXPECT_EQ(endgame::getMaterialKey("KQKR", WHITE), Board("8/8/8/4k3/8/5r2/8/KQ6 b - - 0 1").getMaterialKey());
+    EXPECT_NE(endgame::getMaterialKey("KRKN", WHITE), endgame::getMaterialKey("KRKN", BLACK));
+
+    // the registered endgames are found for both colors
+    Color strong = WHITE;
+    EXPECT_EQ(endgame::findEvaluation(endgame::getMaterialKey("KPK", BLACK), strong), endgame::evaluateKPK);
+    EXPECT_EQ(strong, BLACK);
+    EXPECT_EQ(endgame::findEvaluation(Board().getMaterialKey(), strong), nullptr);
+}
+
+TEST(EndgameTest, KPK) {
+    // the king in front of its pawn on the sixth rank always wins
+    EXPECT_GT(eval::evaluate(Board("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1")), endgame::VALUE_KNOWN_WIN);
+    EXPECT_LT(eval::evaluate(Board("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1")), -endgame::VALUE_KNOWN_WIN);
+
+    // with the king in front of the pawn, it depends on who has the opposition
+    EXPECT_EQ(eval::evaluate(Board("8/4k3/8/4K3/4P3/8/8/8 w - - 0 1")), 0);
+    EXPECT_LT(eval::evaluate(Board("8/4k3/8/4K3/4P3/8/8/8 b - - 0 1")), -endgame::VALUE_KNOWN_WIN);
+
+    // the pawn in front of the king is a draw, since the defending king
+    // blocks it in time
+    EXPECT_EQ(eval::evaluate(Board("4k3/8/4P3/4K3/8/8/8/8 b - - 0 1")), 0);
+
+    // a rook pawn does not win against a king in the corner, and the same
+    // holds for the mirrored positions
+    EXPECT_EQ(eval::evaluate(Board("7k/8/7K/7P/8/8/8/8 w - - 0 1")), 0);
+    EXPECT_EQ(eval::evaluate(Board("8/8/8/8/p7/k7/8/K7 b - - 0 1")), 0);
+    EXPECT_GT(eval::evaluate(Board("8/8/8/8/4p3/4k3/8/4K3 b - - 0 1")), endgame::VALUE_KNOWN_WIN);
+}
+
+TEST(EndgameTest, MatingAdvantage) {
+    // a queen against a bare king is a known win for either side to move
+    EXPECT_GT(eval::evaluate(Board("8/8/8/4k3/8/8/8/KQ6 w - - 0 1")), endgame::VALUE_KNOWN_WIN);
+    EXPECT_LT(eval::evaluate(Board("8/8/8/4k3/8/8/8/KQ6 b - - 0 1")), -endgame::VALUE_KNOWN_WIN);
+    EXPECT_EQ(eval::evaluate(Board("k7/8/1Q6/8/8/8/8/7K b - - 0 1")), 0);
+
+    // the weak king is driven to the edge and towards the strong king
+    Value center = eval::evaluate(Board("8/8/8/4k3/8/8/8/KR6 w - - 0 1"));
+    Value edge = eval::evaluate(Board("4k3/8/4K3/8/8/8/8/1R6 w - - 0 1"));
+    EXPECT_GT(edge, center);
+
+    // with bishop and knight, only the corners of the bishop's color count
+    Value dark_corner = eval::evaluate(Board("8/8/8/8/8/2K5/8/k1B1N3 w - - 0 1"));
+    Value light_corner = eval::evaluate(Board("k7/8/2K5/8/8/8/8/2B1N3 w - - 0 1"));
+    EXPECT_GT(dark_corner, light_corner);
+    EXPECT_GT(light_corner, endgame::VALUE_KNOWN_WIN);
+}
+
+TEST(EndgameTest, Draws) {
+    // without pawns, a single minor piece cannot mate
+    for (const char* fen : {"8/8/8/4k3/8/8/8/K7 w - - 0 1", "8/8/8/4k3/8/8/8/KN6 w - - 0 1", "8/8/8/4kb2/8/8/8/K7 w - - 0 1"}) {
+        material::Entry entry = material::evaluate(Board(fen));
+        EXPECT_TRUE(entry.is_draw) << fen;
+        EXPECT_EQ(eval::evaluate(Board(fen)), 0) << fen;
+    }
+    EXPECT_FALSE(material::evaluate(Board("8/8/8/4k3/8/8/8/KR6 w - - 0 1")).is_draw);
+    EXPECT_EQ(eval::evaluate(Board("8/8/8/4k3/8/8/8/KNN5 w - - 0 1")), 0);
+
+    // bishops of opposite colors scale down the endgame score, those of the
+    // same color do not
+    Board board = Board("4k3/8/3b4/8/3P4/8/8/4KB2 w - - 0 1");
+    material::Entry entry = material::evaluate(board);
+    EXPECT_EQ(entry.getScale(board, WHITE), 24);
+    board = Board("4k3/8/2b5/8/3P4/8/8/4KB2 w - - 0 1");
+    EXPECT_EQ(entry.getScale(board, WHITE), endgame::SCALE_NORMAL);
+
+    // a rook pawn with the wrong bishop cannot win against a king in the corner
+    board = Board("k7/8/8/P7/8/8/8/4K1B1 w - - 0 1");
+    EXPECT_EQ(material::evaluate(board).getScale(board, WHITE), endgame::SCALE_DRAW);
+    board = Board("k7/8/8/P7/8/8/8/4KB2 w - - 0 1");
+    EXPECT_EQ(material::evaluate(board).getScale(board, WHITE), endgame::SCALE_NORMAL);
+
+    // without pawns, rook and knight against rook are hard to win
+    board = Board("8/8/8/4k3/8/5r2/8/KRN5 w - - 0 1");
+    EXPECT_LT(material::evaluate(board).factors[WHITE], endgame::SCALE_NORMAL);
+}
+
+TEST(EndgameTest, Search) {
+    // a dead draw is recognised at the first ply
+    search::Searcher searcher;
+    search::Limits limits;
+    limits.depth = 10;
+    search::Report report = searcher.search(Board("8/8/8/4k3/8/8/8/KN6 w - - 0 1"), limits);
+    EXPECT_EQ(report.score, 0);
+    EXPECT_LT(report.nodes, 100u);
+
+    // the won pawn endgame is found from the bitbase
+    limits.depth = 6;
+    report = searcher.search(Board("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1"), limits);
+    EXPECT_GT(report.score, endgame::VALUE_KNOWN_WIN);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "evaluation.hpp"
+#include "mobility.hpp"
+#include "movegen.hpp"
+
+TEST(MobilityTest, Collect) {
+    // a knight in the corner attacks two squares, and the entries up to the
+    // next multiple of four are empty
+    Board board = Board("4k3/8/8/8/8/8/8/N3K3 w - - 0 1");
+    mobility::AttackTable table;
+    mobility::AttackCounts counts;
+    mobility::collect(board, pawns::evaluate(board), table);
+    mobility::count(table, counts);
+    ASSERT_EQ(table.n_pieces[WHITE], 1);
+    EXPECT_EQ(table.n_pieces[BLACK], 0);
+    EXPECT_EQ(table.types[WHITE][0], KNIGHT);
+    EXPECT_EQ(table.attacks[WHITE][0], bb::getBitboard(B3) | bb::getBitboard(C2));
+    EXPECT_EQ(table.attacks[WHITE][3], 0ULL);
+    EXPECT_EQ(counts.mobility[WHITE][0], 2u);
+
+    // squares attacked by enemy pawns are not part of the mobility area
+    board = Board("4k3/8/8/8/2p5/8/8/N3K3 w - - 0 1");
+    mobility::collect(board, pawns::evaluate(board), table);
+    mobility::count(table, counts);
+    EXPECT_EQ(counts.mobility[WHITE][0], 1u);
+}
+
+TEST(MobilityTest, KingAttacksAndThreats) {
+    // the queen attacks two squares of the king zone, and the knight
+    // threatens the rook
+    Board board = Board("4k3/8/8/3r4/8/2N5/8/4Q1K1 w - - 0 1");
+    mobility::AttackTable table;
+    mobility::AttackCounts counts;
+    mobility::collect(board, pawns::evaluate(board), table);
+    mobility::count(table, counts);
+    EXPECT_EQ(counts.king_attackers[WHITE], 1);
+    EXPECT_EQ(counts.king_attack_weights[WHITE], 2 * mobility::KING_ATTACK_WEIGHTS[QUEEN]);
+    EXPECT_EQ(counts.threats[WHITE], bb::getBitboard(D5));
+    EXPECT_EQ(counts.threats[BLACK], 0ULL);
+
+    // the mirrored position has the opposite score
+    Board mirrored = Board("4q1k1/8/2n5/8/3R4/8/8/4K3 b - - 0 1");
+    EXPECT_EQ(mobility::evaluate(board, pawns::evaluate(board)),
+              -mobility::evaluate(mirrored, pawns::evaluate(mirrored)));
+}
+
+TEST(MobilityTest, CountMatchesScalar) {
+    // the configured counting, which may use AVX2, agrees with the scalar
+    // fallback on all positions after the legal moves, including more
+    // pieces than fit into a single register
+    for (const char* fen : {"r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                            "k7/8/8/8/8/8/8/1QQQQQNK w - - 0 1"}) {
+        Board board = Board(fen);
+        for (const Move& move : MoveList(board)) {
+            board.makeMove(move);
+            mobility::AttackTable table;
+            mobility::AttackCounts counts, expected;
+            mobility::collect(board, pawns::evaluate(board), table);
+            mobility::count(table, counts);
+            mobility::countScalar(table, expected);
+            for (Color color : {WHITE, BLACK}) {
+                for (int index = 0; index < table.n_pieces[color]; index++) {
+                    EXPECT_EQ(counts.mobility[color][index], expected.mobility[color][index]) << fen;
+                }
+                EXPECT_EQ(counts.king_attack_weights[color], expected.king_attack_weights[color]) << fen;
+                EXPECT_EQ(counts.king_attackers[color], expected.king_attackers[color]) << fen;
+                EXPECT_EQ(counts.threats[color], expected.threats[color]) << fen;
+            }
+            board.unmakeMove(move);
+        }
+    }
+}
+
+TEST(MobilityTest, CollectedMatchesPerPiece) {
+    // both variants of the evaluation give the same score on all positions
+    // after the legal moves
+    for (const char* fen : {"r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                            "k7/8/8/8/8/8/8/1QQQQQNK w - - 0 1"}) {
+        Board board = Board(fen);
+        for (const Move& move : MoveList(board)) {
+            board.makeMove(move);
+            pawns::Entry pawns = pawns::evaluate(board);
+            EXPECT_EQ(mobility::evaluatePerPiece(board, pawns), mobility::evaluateCollected(board, pawns)) << fen;
+            board.unmakeMove(move);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "moveorder.hpp"
+
+static std::vector<Move> pickAll(order::MovePicker& picker) {
+    std::vector<Move> moves;
+    for (Move move = picker.next(); move != Move(); move = picker.next()) {
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+TEST(MoveOrderTest, HashMoveFirst) {
+    Board board = Board();
+    order::Heuristics heuristics;
+    Move hash_move = Move(E2, E4, DOUBLE_PAWN_PUSH);
+    order::MovePicker picker(board, hash_move, heuristics, 0, Move());
+    std::vector<Move> moves = pickAll(picker);
+
+    // every legal move is picked exactly once
+    ASSERT_EQ(moves.size(), 20u);
+    EXPECT_EQ(moves[0], hash_move);
+    for (const Move& move : MoveList(board)) {
+        EXPECT_EQ(std::count(moves.begin(), moves.end(), move), 1) << move.toString();
+    }
+}
+
+TEST(MoveOrderTest, CaptureOrder) {
+    // the knight on a4 hangs, while the rook on d5 is defended by a pawn
+    Board board = Board("4k3/8/4p3/3r4/n7/8/8/3QK3 w - - 0 1");
+    order::Heuristics heuristics;
+    order::MovePicker picker(board, Move(), heuristics, 0, Move());
+    std::vector<Move> moves = pickAll(picker);
+    ASSERT_FALSE(moves.empty());
+    EXPECT_EQ(moves.front().toString(), "d1a4");
+    EXPECT_EQ(moves.back().toString(), "d1d5");
+
+    // the quiescence search does not even try the losing capture
+    order::MovePicker quiescence_picker(board, heuristics);
+    moves = pickAll(quiescence_picker);
+    ASSERT_EQ(moves.size(), 1u);
+    EXPECT_EQ(moves[0].toString(), "d1a4");
+}
+
+TEST(MoveOrderTest, KillersAndHistory) {
+    Board board = Board();
+    order::Heuristics heuristics;
+    Move killer = Move(G1, F3, QUIET);
+    Move searched[] = {Move(A2, A3, QUIET), Move(H2, H3, QUIET)};
+    heuristics.update(board, killer, Move(), 3, 4, searched, 2);
+    EXPECT_EQ(heuristics.getKiller(3, 0), killer);
+    EXPECT_GT(heuristics.getHistory(WHITE, killer), 0);
+    EXPECT_LT(heuristics.getHistory(WHITE, searched[0]), 0);
+
+    // without captures, the killer move is the first move to be searched
+    order::MovePicker picker(board, Move(), heuristics, 3, Move());
+    EXPECT_EQ(picker.next(), killer);
+    heuristics.clearKillers();
+    EXPECT_EQ(heuristics.getKiller(3, 0), Move());
+
+    // the history scores stay within their bounds under repeated updates
+    for (int i = 0; i < 1000; i++) {
+        heuristics.update(board, killer, Move(), 0, 20, searched, 2);
+    }
+    EXPECT_LE(heuristics.getHistory(WHITE, killer), order::MAX_HISTORY);
+    EXPECT_GE(heuristics.getHistory(WHITE, searched[0]), -order::MAX_HISTORY);
+    EXPECT_GT(heuristics.getHistory(WHITE, killer), order::MAX_HISTORY / 2);
+
+    // the move that refuted the previous move is its counter move
+    Move previous = Move(E2, E4, DOUBLE_PAWN_PUSH);
+    board.makeMove(previous);
+    Move counter_move = Move(E7, E5, DOUBLE_PAWN_PUSH);
+    heuristics.update(board, counter_move, previous, 1, 2, nullptr, 0);
+    EXPECT_EQ(heuristics.getCounterMove(board, previous), counter_move);
+    heuristics.clear();
+    EXPECT_EQ(heuristics.getCounterMove(board, previous), Move());
+    EXPECT_EQ(heuristics.getHistory(WHITE, killer), 0);
+}
+
+TEST(MoveOrderTest, CounterMoveAfterBlackKing) {
+    order::Heuristics heuristics;
+    Board board = Board("4k3/8/8/8/8/8/8/R3K3 b - - 0 1");
+
+    // the black king has the highest piece id and must still index the table
+    Move previous = Move(E8, D8, QUIET);
+    board.makeMove(previous);
+    Move counter_move = Move(A1, A8, QUIET);
+    heuristics.update(board, counter_move, previous, 1, 2, nullptr, 0);
+    EXPECT_EQ(heuristics.getCounterMove(board, previous), counter_move);
+    heuristics.clear();
+    EXPECT_EQ(heuristics.getCounterMove(board, previous), Move());
+}
+
+TEST(MoveOrderTest, MovesFromOtherPositions) {
+    // the hash move, the killer moves and the counter move stem from other
+    // positions, illegal ones are skipped and legal ones are picked only once
+    Board board = Board("4k3/8/4p3/3r4/n7/8/8/3QK3 w - - 0 1");
+    order::Heuristics heuristics;
+    Move killer = Move(D1, D4, QUIET);
+    Move previous = Move(B6, A4, QUIET);
+    heuristics.update(board, Move(E1, D2, QUIET), Move(), 0, 1, nullptr, 0);
+    heuristics.update(board, killer, previous, 0, 1, nullptr, 0);
+    order::MovePicker picker(board, Move(E2, E4, DOUBLE_PAWN_PUSH), heuristics, 0, previous);
+    std::vector<Move> moves = pickAll(picker);
+    MoveList legal_moves = MoveList(board);
+    ASSERT_EQ(moves.size(), legal_moves.size());
+    for (const Move& move : legal_moves) {
+        EXPECT_EQ(std::count(moves.begin(), moves.end(), move), 1) << move.toString();
+    }
+
+    // the winning capture, the legal killer move, the quiet moves and the
+    // losing capture
+    EXPECT_EQ(moves[0].toString(), "d1a4");
+    EXPECT_EQ(moves[1], killer);
+    EXPECT_EQ(moves.back().toString(), "d1d5");
+}
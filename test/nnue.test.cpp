@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "evaluation.hpp"
+#include "movegen.hpp"
+#include "nnue.hpp"
+
+/* @brief Create the file of a network with random parameters.
+ * @param seed The seed of the random numbers.
+ * @return The contents of the file. */
+static std::string createRandomNetwork(unsigned seed) {
+    std::mt19937 generator(seed);
+    std::ostringstream stream;
+    auto write = [&] <typename T> (const T* data, size_t count) {
+        stream.write(reinterpret_cast<const char*>(data), std::streamsize(sizeof(T) * count));
+    };
+    auto writeRandom = [&] <typename T> (size_t count, int low, int high) {
+        std::uniform_int_distribution<int> distribution(low, high);
+        std::vector<T> values(count);
+        std::generate(values.begin(), values.end(), [&] { return T(distribution(generator)); });
+        write(values.data(), count);
+    };
+    std::string description = "random network";
+    uint32_t header[] = {nnue::VERSION, 0, uint32_t(description.size())};
+    uint32_t hash = 0;
+    write(header, 3);
+    write(description.data(), description.size());
+    write(&hash, 1);
+    writeRandom.operator()<int16_t>(nnue::N_HIDDEN, 0, 64);
+    writeRandom.operator()<int16_t>(size_t(nnue::N_FEATURES) * nnue::N_HIDDEN, -16, 16);
+    write(&hash, 1);
+    writeRandom.operator()<int32_t>(nnue::N_LAYER_1, -2000, 2000);
+    writeRandom.operator()<int8_t>(nnue::N_LAYER_1 * nnue::N_INPUTS, -8, 8);
+    writeRandom.operator()<int32_t>(nnue::N_LAYER_2, -2000, 2000);
+    writeRandom.operator()<int8_t>(nnue::N_LAYER_2 * nnue::N_LAYER_1, -64, 64);
+    writeRandom.operator()<int32_t>(1, -2000, 2000);
+    writeRandom.operator()<int8_t>(nnue::N_LAYER_2, -64, 64);
+    return stream.str();
+}
+
+/* @brief Load a network with random parameters. */
+static void loadRandomNetwork(unsigned seed = 1) {
+    std::istringstream stream(createRandomNetwork(seed));
+    nnue::load(stream);
+}
+
+/* @brief Make and unmake all moves up to a depth, testing that the first
+ *  layer of the network is updated like it is computed from scratch. */
+static void testUpdates(Board& board, int depth) {
+    ASSERT_EQ(board.getNetworkAccumulator(), nnue::computeAccumulator(board));
+    if (depth == 0) {
+        return;
+    }
+    for (const Move& move : MoveList(board)) {
+        board.makeMove(move);
+        testUpdates(board, depth - 1);
+        board.unmakeMove(move);
+        ASSERT_EQ(board.getNetworkAccumulator(), nnue::computeAccumulator(board)) << move.toString();
+    }
+}
+
+/* @brief Rotate a position by 180 degrees and swap the colors of all pieces,
+ *  which the network sees the same from the view of the side to move. */
+static Board rotate(const std::string& fen) {
+    std::vector<std::string> fields = utils::tokenize(fen, ' ');
+    std::vector<std::string> ranks = utils::tokenize(fields[0], '/');
+    std::string placement;
+    for (auto rank = ranks.rbegin(); rank != ranks.rend(); ++rank) {
+        std::string rotated(rank->rbegin(), rank->rend());
+        for (char& symbol : rotated) {
+            symbol = isupper(symbol) ? tolower(symbol) : toupper(symbol);
+        }
+        placement += (placement.empty() ? "" : "/") + rotated;
+    }
+    return Board(placement + (fields[1] == "w" ? " b" : " w") + " - - 0 1");
+}
+
+TEST(NNUETest, Load) {
+    nnue::unload();
+    EXPECT_THROW(nnue::load("missing.nnue"), InvalidNetworkException);
+
+    // a file of another version or architecture is rejected and keeps the
+    // loaded network
+    std::string network = createRandomNetwork(1);
+    std::istringstream truncated(network.substr(0, network.size() - 1));
+    EXPECT_THROW(nnue::load(truncated), InvalidNetworkException);
+    std::istringstream trailing(network + "x");
+    EXPECT_THROW(nnue::load(trailing), InvalidNetworkException);
+    std::istringstream version("\x01\x02\x03\x04");
+    EXPECT_THROW(nnue::load(version), InvalidNetworkException);
+    EXPECT_FALSE(nnue::isLoaded());
+
+    std::istringstream stream(network);
+    nnue::load(stream);
+    EXPECT_TRUE(nnue::isLoaded());
+    nnue::unload();
+    EXPECT_FALSE(nnue::isLoaded());
+}
+
+TEST(NNUETest, IncrementalUpdates) {
+    loadRandomNetwork();
+
+    // captures, promotions, en passant captures and castling of both sides,
+    // where king moves are refreshed from the cache
+    for (const char* fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"}) {
+        Board board = Board(fen);
+        testUpdates(board, 2);
+    }
+
+    // a board set up before the network was loaded is brought up to date
+    // by the next move
+    Board board = Board();
+    loadRandomNetwork(2);
+    EXPECT_NE(board.getNetworkAccumulator().generation, nnue::getGeneration());
+    EXPECT_EQ(nnue::evaluate(board), nnue::propagate(nnue::computeAccumulator(board), WHITE));
+    Move move = *MoveList(board).begin();
+    board.makeMove(move);
+    EXPECT_EQ(board.getNetworkAccumulator(), nnue::computeAccumulator(board));
+    board.unmakeMove(move);
+    EXPECT_EQ(board.getNetworkAccumulator(), nnue::computeAccumulator(board));
+    nnue::unload();
+}
+
+TEST(NNUETest, Propagate) {
+    Value classical = eval::evaluate(Board());
+    loadRandomNetwork();
+    for (const char* fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                            "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+                            "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 b - - 0 10"}) {
+        // the configured kernels, which may use AVX2, agree with the scalar
+        // fallback for both sides to move
+        Board board = Board(fen);
+        for (Color color : {WHITE, BLACK}) {
+            EXPECT_EQ(nnue::propagate(board.getNetworkAccumulator(), color),
+                      nnue::propagateScalar(board.getNetworkAccumulator(), color)) << fen;
+        }
+
+        // the network replaces the classical evaluation and sees the rotated
+        // position with swapped colors the same
+        EXPECT_EQ(eval::evaluate(board), nnue::evaluate(board)) << fen;
+        EXPECT_EQ(nnue::evaluate(board), nnue::evaluate(rotate(fen))) << fen;
+    }
+    nnue::unload();
+    EXPECT_EQ(eval::evaluate(Board()), classical);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "evaluation.hpp"
+#include "pawns.hpp"
+#include "search.hpp"
+
+TEST(PawnsTest, Structure) {
+    // two isolated passed pawns on the second rank
+    pawns::Entry entry = pawns::evaluate(Board("4k3/8/8/8/8/8/2P1P3/4K3 w - - 0 1"));
+    psqt::Score expected = pawns::ISOLATED * 2 + pawns::PASSED[RANK_2] * 2;
+    EXPECT_EQ(entry.score, expected);
+    EXPECT_EQ(entry.passed[WHITE], bb::getBitboard(C2) | bb::getBitboard(E2));
+    EXPECT_EQ(entry.attacks[WHITE], bb::getBitboard(B3) | bb::getBitboard(D3) | bb::getBitboard(F3));
+
+    // doubled pawns count once
+    entry = pawns::evaluate(Board("4k3/8/8/8/8/2P5/2P5/4K3 w - - 0 1"));
+    expected = pawns::ISOLATED * 2 + pawns::DOUBLED + pawns::PASSED[RANK_2] + pawns::PASSED[RANK_3];
+    EXPECT_EQ(entry.score, expected);
+
+    // the pawn on d3 is backward, since it cannot advance without being
+    // taken and the pawn on c4 can no longer defend it, while the pawn on e5
+    // is isolated and neither side's pawns on the d- and e-files are passed
+    entry = pawns::evaluate(Board("4k3/8/8/4p3/2P5/3P4/8/4K3 w - - 0 1"));
+    expected = pawns::BACKWARD + pawns::PASSED[RANK_4] - pawns::ISOLATED;
+    EXPECT_EQ(entry.score, expected);
+    EXPECT_EQ(entry.passed[WHITE], bb::getBitboard(C4));
+    EXPECT_EQ(entry.passed[BLACK], 0ULL);
+
+    // the mirrored position has the opposite score
+    Board board = Board("4k3/p7/8/3P4/8/2P5/2P4P/4K3 w - - 0 1");
+    Board mirrored = Board("4k3/2p4p/2p5/8/3p4/8/P7/4K3 b - - 0 1");
+    EXPECT_EQ(pawns::evaluate(board).score, -pawns::evaluate(mirrored).score);
+    EXPECT_EQ(eval::evaluate(board), eval::evaluate(mirrored));
+}
+
+TEST(PawnsTest, Shelter) {
+    Board board = Board("6k1/5ppp/8/8/8/6P1/5P1P/6K1 w - - 0 1");
+    pawns::Entry entry = pawns::evaluate(board);
+    EXPECT_EQ(entry.getShelter(board, WHITE), 2 * pawns::SHELTER[0] + pawns::SHELTER[1]);
+    EXPECT_EQ(entry.getShelter(board, BLACK), 3 * pawns::SHELTER[0]);
+
+    // the shelter follows the king with the same pawns
+    board = Board("6k1/5ppp/8/8/8/6P1/5P1P/3K4 w - - 0 1");
+    EXPECT_EQ(entry.getShelter(board, WHITE), 0);
+}
+
+TEST(PawnsTest, PawnTable) {
+    pawns::PawnTable table;
+    material::MaterialTable material_table;
+    Board board = Board("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+    Value score = eval::evaluate(board);
+    EXPECT_EQ(eval::evaluate(board, table, material_table), score);
+    EXPECT_EQ(table.getProbes(), 1u);
+    EXPECT_EQ(table.getHits(), 0u);
+
+    // moves of the other pieces keep the pawn structure, and therefore hit
+    for (const Move& move : MoveList(board)) {
+        board.makeMove(move);
+        EXPECT_EQ(eval::evaluate(board, table, material_table), eval::evaluate(board)) << move.toString();
+        board.unmakeMove(move);
+        EXPECT_EQ(eval::evaluate(board, table, material_table), score);
+    }
+    EXPECT_GT(table.getHits(), table.getProbes() * 3 / 4);
+    table.resetStatistics();
+    EXPECT_EQ(table.getProbes(), 0u);
+
+    // almost all evaluations of a search find the pawn structure cached, the
+    // exact rate depends on the move order and lies around 90 percent
+    search::Searcher searcher;
+    search::Limits limits;
+    limits.depth = 6;
+    search::Report report = searcher.search(board, limits);
+    EXPECT_GT(report.pawn_probes, 0u);
+    EXPECT_GT(report.pawn_hits, report.pawn_probes * 85 / 100);
+}
@@ -1,13 +1,20 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <vector>
 #include "board.hpp"
-#include "movegen.hpp"
+#include "perft.hpp"
 
 #define MAX_DEPTH 6
 #define ENABLE_DETAILED_LOGGING 0
+#define ENABLE_BULK_COUNTING 1
+#define ENABLE_DYNAMIC_SPLIT 1
+#define N_THREADS 0                 // 0: use all available hardware threads
+#define CACHE_SIZE_MB 256           // 0: disable the shared perft cache
 
 struct PerftTestCase {
     std::string fen;
@@ -34,8 +41,7 @@ std::vector<PerftTestCase> PERFT_TEST_CASES = {
     // position 4
     {
         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
-        //"r3k2r/Pppp1ppp/1b3nbN/nPP5/BB2P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1",     // c4c5, fails after b2a1 rook promotion capture (probably due to something related to the castling rights!)
-        {6, 264, 9467, 422333, 15833292, 706045033}                             // NOTE: currently fails at depth 6
+        {6, 264, 9467, 422333, 15833292, 706045033}
     },
     // position 5
     {
@@ -49,46 +55,7 @@ std::vector<PerftTestCase> PERFT_TEST_CASES = {
     }
 };
 
-uint64_t perft(Board& board, int depth, bool enable_detailed_logging/*, std::string movestring = ""*/) {
-    uint64_t nodes = 0;
-
-    //std::cout << movestring << std::endl;
-    
-    // end search if base depth has been reached
-    if (depth == 0) {
-        return 1ULL;
-    }
-
-    // generate all pseudo-legal moves
-    MoveList movelist = MoveList(board);
-
-    for (const Move& move : movelist) {
-        board.makeMove(move);
-        
-        // check for legality of the move
-        if (!board.isInCheck(!board.getSideToMove())) {
-            uint64_t childNodes = perft(board, depth - 1, false/*, movestring + "-" + move.toString()*/);
-            nodes += childNodes;
-
-            if (enable_detailed_logging && depth != 1) {
-                std::cout << move.toString() << ": " << childNodes << std::endl;
-            }
-        }
-
-        board.unmakeMove(move);
-    }
-
-    return nodes;
-}
-
-class PerftTest : public ::testing::Test {
-protected:
-    void SetUp() override {
-        attacks::precalculate(true);
-    }
-};
-
-TEST_F(PerftTest, MoveGeneration) {
+TEST(PerftTest, MoveGeneration) {
     std::cout << std::fixed << std::setprecision(2);
 
     for (const PerftTestCase& test_case : PERFT_TEST_CASES) {
@@ -110,7 +77,7 @@ TEST_F(PerftTest, MoveGeneration) {
             Board board = Board(fen);
 
             auto start = std::chrono::high_resolution_clock::now();
-            uint64_t result = perft(board, depth, ENABLE_DETAILED_LOGGING);
+            uint64_t result = perft::countNodes(board, depth, ENABLE_BULK_COUNTING, ENABLE_DETAILED_LOGGING);
             auto end = std::chrono::high_resolution_clock::now();
 
             uint64_t expected = expected_values[depth - 1];
@@ -132,3 +99,65 @@ TEST_F(PerftTest, MoveGeneration) {
         std::cout << std::endl;
     }
 }
+
+TEST(PerftTest, ParallelMoveGeneration) {
+    std::cout << std::fixed << std::setprecision(2);
+    int n_threads = N_THREADS > 0 ? N_THREADS : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Threads: " << n_threads << std::endl;
+    std::unique_ptr<perft::Cache> cache = CACHE_SIZE_MB > 0 ? std::make_unique<perft::Cache>(CACHE_SIZE_MB) : nullptr;
+
+    for (const PerftTestCase& test_case : PERFT_TEST_CASES) {
+        // extract and print test case parameters
+        std::vector<uint64_t> expected_values = test_case.nodes;
+        std::string fen = test_case.fen;
+        std::cout << std::endl;
+        std::cout << "FEN: " << fen << std::endl;
+        std::cout << std::endl;
+        std::cout << std::setw(6)  << "Depth"
+                << std::setw(16) << "Expected"
+                << std::setw(16) << "Result"
+                << std::setw(10) << "Time [s]"
+                << std::setw(16) << "Speed [nps]"
+                << std::endl;
+
+        perft::ParallelResult result;
+        for (size_t depth = 1; depth <= MAX_DEPTH && depth <= expected_values.size(); ++depth) {
+            Board board = Board(fen);
+            result = perft::countNodesParallel(board, depth, n_threads, ENABLE_BULK_COUNTING, ENABLE_DYNAMIC_SPLIT, cache.get());
+            uint64_t expected = expected_values[depth - 1];
+            std::string msg = result.nodes == expected ? "" : "failed";
+
+            std::cout << std::setw(6) << depth
+                    << std::setw(16) << expected
+                    << std::setw(16) << result.nodes
+                    << std::setw(10) << result.seconds
+                    << std::setw(16) << result.nodes / result.seconds
+                    << std::setw(8) << msg << std::endl;
+
+            EXPECT_EQ(result.nodes, expected) << "Perft failed at depth " << depth << " for FEN: " << fen;
+        }
+
+        // print the node counts per root move and the statistics per thread of the deepest search
+        std::cout << std::endl;
+        if (ENABLE_DETAILED_LOGGING) {
+            for (const auto& [move, nodes] : result.divide) {
+                std::cout << move.toString() << ": " << nodes << std::endl;
+            }
+            std::cout << std::endl;
+        }
+        for (size_t t = 0; t < result.threads.size(); ++t) {
+            const perft::ThreadStatistics& thread = result.threads[t];
+            std::cout << "Thread " << std::setw(3) << t
+                    << std::setw(16) << thread.nodes
+                    << std::setw(10) << thread.seconds
+                    << std::setw(16) << thread.nodes / thread.seconds
+                    << std::endl;
+        }
+        if (cache) {
+            std::cout << "Cache hit rate: " << 100.0 * result.cache.getHitRate() << " % of "
+                    << result.cache.probes << " probes" << std::endl;
+            cache->clear();
+        }
+        std::cout << std::endl;
+    }
+}
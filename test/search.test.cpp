@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "search.hpp"
+
+static search::Limits getDepthLimit(int depth) {
+    search::Limits limits;
+    limits.depth = depth;
+    return limits;
+}
+
+TEST(SearchTest, MateInOne) {
+    Board board = Board("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    search::Searcher searcher;
+    search::Report report = searcher.search(board, getDepthLimit(4));
+    ASSERT_FALSE(report.pv.empty());
+    EXPECT_EQ(report.pv[0].toString(), "d1d8");
+    EXPECT_TRUE(search::isMateScore(report.score));
+    EXPECT_EQ(search::getMateDistance(report.score), 1);
+}
+
+TEST(SearchTest, MatedAtRoot) {
+    // checkmated and stalemated positions have no best move
+    for (const char* fen : {"3R2k1/5ppp/8/8/8/8/5PPP/6K1 b - - 0 1", "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"}) {
+        Board board = Board(fen);
+        search::Searcher searcher;
+        search::Report report = searcher.search(board, getDepthLimit(3));
+        EXPECT_TRUE(report.pv.empty()) << fen;
+    }
+}
+
+TEST(SearchTest, WinsHangingQueen) {
+    Board board = Board("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    search::Searcher searcher;
+    search::Report report = searcher.search(board, getDepthLimit(3));
+    ASSERT_FALSE(report.pv.empty());
+    EXPECT_EQ(report.pv[0].toString(), "d2d5");
+    EXPECT_GT(report.score, 0);
+}
+
+TEST(SearchTest, PrincipalVariationIsLegal) {
+    Board board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    Key key = board.getKey();
+    search::Searcher searcher;
+    search::Report report = searcher.search(board, getDepthLimit(4));
+    EXPECT_EQ(report.depth, 4);
+    EXPECT_EQ(board.getKey(), key);
+
+    // every move of the principal variation must be legal in its position
+    for (const Move& move : report.pv) {
+        MoveList movelist(board);
+        EXPECT_NE(std::find(movelist.begin(), movelist.end(), move), movelist.end()) << move.toString();
+        board.makeMove(move);
+    }
+}
+
+TEST(SearchTest, NodeLimit) {
+    Board board = Board();
+    search::Limits limits;
+    limits.nodes = 10000;
+    search::Searcher searcher;
+    search::Report report = searcher.search(board, limits);
+    EXPECT_LE(report.nodes, limits.nodes);
+    EXPECT_FALSE(report.pv.empty());
+}
+
+TEST(SearchTest, TimeLimit) {
+    Board board = Board();
+    search::Limits limits;
+    limits.move_time = 100;
+    search::Searcher searcher;
+    search::Report report = searcher.search(board, limits);
+    EXPECT_LT(report.seconds, 0.5);
+    EXPECT_FALSE(report.pv.empty());
+}
+
+TEST(SearchTest, TranspositionTable) {
+    Board board = Board("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10");
+    search::Searcher searcher;
+    search::Report report = searcher.search(board, getDepthLimit(4));
+
+    // the table saves nodes but does not change the result at this depth
+    tt::TranspositionTable table(1);
+    search::Searcher table_searcher(&table);
+    search::Report table_report = table_searcher.search(board, getDepthLimit(4));
+    EXPECT_LT(table_report.nodes, report.nodes);
+    EXPECT_EQ(table_report.score, report.score);
+    EXPECT_GT(table.getHashfull(), 0);
+}
+
+TEST(SearchTest, MultipleThreads) {
+    tt::TranspositionTable table(1);
+    search::Searcher searcher(&table, 4);
+    EXPECT_EQ(searcher.getThreads(), 4);
+
+    Board board = Board("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    search::Report report = searcher.search(board, getDepthLimit(4));
+    ASSERT_FALSE(report.pv.empty());
+    EXPECT_EQ(report.pv[0].toString(), "d1d8");
+    EXPECT_EQ(search::getMateDistance(report.score), 1);
+
+    // the node limit applies to the nodes of all threads together
+    board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    search::Limits limits;
+    limits.nodes = 20000;
+    report = searcher.search(board, limits);
+    EXPECT_GE(report.nodes, limits.nodes);
+    EXPECT_LT(report.nodes, 2 * limits.nodes);
+
+    report = searcher.search(board, getDepthLimit(4));
+    EXPECT_GE(report.depth, 3);
+    for (const Move& move : report.pv) {
+        MoveList movelist(board);
+        EXPECT_NE(std::find(movelist.begin(), movelist.end(), move), movelist.end()) << move.toString();
+        board.makeMove(move);
+    }
+}
+
+TEST(SearchTest, QuiescenceSearch) {
+    // a depth one search sees that the rook on d5 is defended by the pawn on
+    // e6, while the knight on a4 can be taken for free
+    Board board = Board("4k3/8/4p3/3r4/n7/8/8/3QK3 w - - 0 1");
+    search::Searcher searcher;
+    search::Report report = searcher.search(board, getDepthLimit(1));
+    ASSERT_FALSE(report.pv.empty());
+    EXPECT_EQ(report.pv[0].toString(), "d1a4");
+    EXPECT_GT(report.qnodes, 0u);
+    EXPECT_LT(report.qnodes, report.nodes);
+
+    // taking the queen only wins back the difference of queen and rook, since
+    // the rook on d8 recaptures, the pawns keep the endgame from being a
+    // known loss against a bare king
+    board = Board("3rk3/p7/8/3q4/8/8/P7/3RK3 w - - 0 1");
+    report = searcher.search(board, getDepthLimit(1));
+    ASSERT_FALSE(report.pv.empty());
+    EXPECT_EQ(report.pv[0].toString(), "d1d5");
+    EXPECT_LT(report.score, -300);
+}
+
+TEST(SearchTest, SelectivePruning) {
+    // every technique can be switched off on its own without breaking the
+    // search, and together they shrink the tree
+    search::Options none;
+    none.null_move_pruning = none.late_move_reductions = none.reverse_futility_pruning = false;
+    none.futility_pruning = none.late_move_pruning = false;
+    std::vector<search::Options> variants = {search::Options(), none};
+    bool search::Options::* switches[] = {
+        &search::Options::null_move_pruning, &search::Options::late_move_reductions,
+        &search::Options::reverse_futility_pruning, &search::Options::futility_pruning,
+        &search::Options::late_move_pruning};
+    for (bool search::Options::* option : switches) {
+        search::Options variant;
+        variant.*option = false;
+        variants.push_back(variant);
+    }
+
+    std::vector<uint64_t> nodes;
+    for (const search::Options& options : variants) {
+        search::Searcher searcher;
+        searcher.setOptions(options);
+
+        Board board = Board("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+        search::Report report = searcher.search(board, getDepthLimit(4));
+        ASSERT_FALSE(report.pv.empty());
+        EXPECT_EQ(report.pv[0].toString(), "d1d8");
+
+        board = Board("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10");
+        report = searcher.search(board, getDepthLimit(5));
+        EXPECT_EQ(report.depth, 5);
+        nodes.push_back(report.nodes);
+    }
+    EXPECT_LT(nodes[0], nodes[1]);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "transposition.hpp"
+
+TEST(TranspositionTableTest, StoreAndProbe) {
+    tt::TranspositionTable table(1);
+    Key key = 0x123456789ABCDEF0ULL;
+    tt::Entry entry;
+    EXPECT_FALSE(table.probe(key, entry));
+
+    // all fields survive packing, including negative scores
+    Move move = Move(E7, E8, QUEEN_PROMOTION);
+    table.store(key, move, -31990, 12, tt::BOUND_LOWER);
+    ASSERT_TRUE(table.probe(key, entry));
+    EXPECT_EQ(entry.move, move);
+    EXPECT_EQ(entry.score, -31990);
+    EXPECT_EQ(entry.depth, 12);
+    EXPECT_EQ(entry.bound, tt::BOUND_LOWER);
+
+    // storing the same position without a move keeps the previous move
+    table.store(key, Move(), 50, 13, tt::BOUND_UPPER);
+    ASSERT_TRUE(table.probe(key, entry));
+    EXPECT_EQ(entry.move, move);
+    EXPECT_EQ(entry.score, 50);
+
+    table.clear();
+    EXPECT_FALSE(table.probe(key, entry));
+}
+
+TEST(TranspositionTableTest, Replacement) {
+    tt::TranspositionTable table(1);
+
+    // small keys all map onto the first bucket, which holds four entries
+    std::vector<Key> bucket_keys;
+    for (Key key = 1; bucket_keys.size() < 6; key++) {
+        bucket_keys.push_back(key);
+    }
+    for (int i = 0; i < 4; i++) {
+        table.store(bucket_keys[i], Move(), 0, 2 + i, tt::BOUND_EXACT);
+    }
+
+    // the shallowest entry is replaced
+    tt::Entry entry;
+    table.store(bucket_keys[4], Move(), 0, 1, tt::BOUND_EXACT);
+    EXPECT_FALSE(table.probe(bucket_keys[0], entry));
+    EXPECT_TRUE(table.probe(bucket_keys[1], entry));
+    EXPECT_TRUE(table.probe(bucket_keys[4], entry));
+
+    // entries of earlier searches are replaced before shallower current ones
+    table.newSearch();
+    table.store(bucket_keys[0], Move(), 0, 1, tt::BOUND_EXACT);
+    table.store(bucket_keys[5], Move(), 0, 1, tt::BOUND_EXACT);
+    EXPECT_TRUE(table.probe(bucket_keys[0], entry));
+    EXPECT_TRUE(table.probe(bucket_keys[5], entry));
+    EXPECT_FALSE(table.probe(bucket_keys[4], entry));
+    EXPECT_FALSE(table.probe(bucket_keys[1], entry));
+    EXPECT_TRUE(table.probe(bucket_keys[2], entry));
+}
+
+TEST(TranspositionTableTest, ParallelClearAndHashfull) {
+    tt::TranspositionTable table(4, 4);
+    EXPECT_EQ(table.getHashfull(), 0);
+
+    // entries of the current search count towards the occupancy
+    for (Key key = 1; key <= table.getNumberOfEntries(); key++) {
+        table.store(key * 0x9E3779B97F4A7C15ULL, Move(), 0, 1, tt::BOUND_EXACT);
+    }
+    EXPECT_GT(table.getHashfull(), 500);
+    table.newSearch();
+    EXPECT_EQ(table.getHashfull(), 0);
+
+    table.newSearch();
+    table.store(1, Move(), 0, 1, tt::BOUND_EXACT);
+    table.clear(3);
+    tt::Entry entry;
+    EXPECT_FALSE(table.probe(1, entry));
+    EXPECT_EQ(table.getHashfull(), 0);
+
+    table.resize(2, 8);
+    EXPECT_EQ(table.getNumberOfEntries(), (2u << 20) / 16);
+}